@@ -0,0 +1,366 @@
+#include "AdversarialSearch.hpp"
+#include "LomutoPartition.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace adversary {
+
+namespace {
+
+// The visualizer's quickSort with the comparisons routed through `less`:
+// the same Lomuto partition, left range first
+void lomutoQuickSort(std::vector<int>& arr, const std::function<bool(int, int)>& less) {
+    std::vector<std::pair<int, int>> ranges;
+    ranges.emplace_back(0, static_cast<int>(arr.size()) - 1);
+    while (!ranges.empty()) {
+        auto [lo, hi] = ranges.back();
+        ranges.pop_back();
+        if (lo >= hi) continue;
+        int p = lomutoPartition(arr, lo, hi, less);
+        ranges.emplace_back(p + 1, hi);
+        ranges.emplace_back(lo, p - 1);
+    }
+}
+
+long long countComparisons(const std::vector<int>& input,
+                           void (*sort)(std::vector<int>&, const std::function<bool(int, int)>&)) {
+    std::vector<int> work = input;
+    long long comparisons = 0;
+    sort(work, [&comparisons](int a, int b) {
+        comparisons++;
+        return a < b;
+    });
+    return comparisons;
+}
+
+void introsort(std::vector<int>& arr, const std::function<bool(int, int)>& less) {
+    std::sort(arr.begin(), arr.end(), less);
+}
+
+// bucketSort's scatter and per-bucket std::sort on keys value / kBucketScale
+long long bucketComparisons(const std::vector<int>& input) {
+    const size_t n = input.size();
+    std::vector<std::vector<float>> buckets(n);
+    for (int value : input) {
+        float key = static_cast<float>(value) / kBucketScale;
+        size_t index = static_cast<size_t>(key * n);
+        if (index >= n) index = n - 1;
+        buckets[index].push_back(key);
+    }
+    long long comparisons = 0;
+    for (auto& bucket : buckets) {
+        std::sort(bucket.begin(), bucket.end(), [&comparisons](float a, float b) {
+            comparisons++;
+            return a < b;
+        });
+    }
+    return comparisons;
+}
+
+std::vector<int> randomCandidate(const Target& target, size_t n, std::mt19937& rng) {
+    std::vector<int> candidate(n);
+    if (target.permutation) {
+        std::iota(candidate.begin(), candidate.end(), 0);
+        std::shuffle(candidate.begin(), candidate.end(), rng);
+    } else {
+        std::uniform_int_distribution<int> value(0, kBucketScale - 1);
+        for (int& v : candidate) v = value(rng);
+    }
+    return candidate;
+}
+
+// Structured starting points that random inputs almost never come close
+// to: sorted and reversed order for permutations (Lomuto's worst case is
+// sorted input), and for bucket keys every key piled into the first bucket
+std::vector<std::vector<int>> extremeCandidates(const Target& target, size_t n) {
+    std::vector<int> ascending(n);
+    std::iota(ascending.begin(), ascending.end(), 0);
+    if (!target.permutation) {
+        // Distinct keys below 1/n, so they share bucket 0
+        const int width = std::max(1, kBucketScale / static_cast<int>(n));
+        for (size_t i = 0; i < n; i++) ascending[i] = static_cast<int>(i * width / n);
+        return {ascending};
+    }
+    std::vector<int> descending(ascending.rbegin(), ascending.rend());
+    return {ascending, descending};
+}
+
+void mutate(const Target& target, std::vector<int>& candidate, std::mt19937& rng) {
+    const size_t n = candidate.size();
+    if (n < 2) return;
+    std::uniform_int_distribution<size_t> position(0, n - 1);
+    size_t a = position(rng);
+    size_t b = position(rng);
+
+    if (target.permutation) {
+        size_t lo = std::min(a, b);
+        size_t hi = std::max(a, b);
+        switch (std::uniform_int_distribution<int>(0, 3)(rng)) {
+            case 0: std::swap(candidate[a], candidate[b]); break;
+            case 1: std::reverse(candidate.begin() + lo, candidate.begin() + hi + 1); break;
+            case 2: {
+                // Move one element, shifting the ones between
+                if (a < b) std::rotate(candidate.begin() + a, candidate.begin() + a + 1, candidate.begin() + b + 1);
+                else std::rotate(candidate.begin() + b, candidate.begin() + a, candidate.begin() + a + 1);
+                break;
+            }
+            default: {
+                // Rotate a whole segment, moving a block of neighbours at once
+                size_t shift = std::uniform_int_distribution<size_t>(0, hi - lo)(rng);
+                std::rotate(candidate.begin() + lo, candidate.begin() + lo + shift, candidate.begin() + hi + 1);
+            }
+        }
+        return;
+    }
+
+    switch (std::uniform_int_distribution<int>(0, 2)(rng)) {
+        case 0: candidate[a] = std::uniform_int_distribution<int>(0, kBucketScale - 1)(rng); break;
+        case 1: {
+            // Pile a value next to another one, so buckets fill up
+            int spread = std::max(1, kBucketScale / static_cast<int>(n) / 4);
+            int jitter = std::uniform_int_distribution<int>(-spread, spread)(rng);
+            candidate[a] = std::clamp(candidate[b] + jitter, 0, kBucketScale - 1);
+            break;
+        }
+        default: std::swap(candidate[a], candidate[b]);
+    }
+}
+
+template <class Fn>
+void forEachParallel(size_t count, unsigned threads, const Fn& fn) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < count; i = next++) fn(i);
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++) workers.emplace_back(worker);
+    worker();
+    for (std::thread& w : workers) w.join();
+}
+
+} // namespace
+
+const std::vector<Target>& targets() {
+    static const std::vector<Target> all = {
+        {"quickSort", true,
+         [](const std::vector<int>& input) { return countComparisons(input, lomutoQuickSort); },
+         lomutoQuickSort},
+        {"std::sort", true,
+         [](const std::vector<int>& input) { return countComparisons(input, introsort); },
+         introsort},
+        {"bucketSort", false, bucketComparisons, {}},
+    };
+    return all;
+}
+
+const Target* findTarget(const std::string& name) {
+    for (const Target& target : targets()) {
+        if (target.name == name) return &target;
+    }
+    return nullptr;
+}
+
+std::vector<int> antiqsort(const Target& target, size_t n) {
+    if (!target.sortWith || n == 0) return {};
+
+    // Unfixed items ("gas") compare above every fixed ("solid") one. When
+    // two gas items meet, the one that is not the pivot candidate is frozen
+    // at the next solid value, so the candidate stays extreme.
+    const int gas = static_cast<int>(n);
+    std::vector<int> value(n, gas);
+    int solids = 0;
+    int candidate = 0;
+    auto less = [&](int x, int y) {
+        if (value[x] == gas && value[y] == gas) {
+            if (x == candidate) value[x] = solids++;
+            else value[y] = solids++;
+        }
+        if (value[x] == gas) candidate = x;
+        else if (value[y] == gas) candidate = y;
+        return value[x] < value[y];
+    };
+
+    std::vector<int> items(n);
+    std::iota(items.begin(), items.end(), 0);
+    target.sortWith(items, less);
+
+    // Items never compared as gas are left; give them the remaining ranks
+    for (int& v : value) {
+        if (v == gas) v = solids++;
+    }
+    return value;
+}
+
+double score(const Target& target, const std::vector<int>& input, Objective objective) {
+    if (objective == Objective::Comparisons) return static_cast<double>(target.comparisons(input));
+    double best = 0.0;
+    for (int run = 0; run < 3; run++) {
+        auto startTime = std::chrono::steady_clock::now();
+        target.comparisons(input);
+        auto endTime = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(endTime - startTime).count();
+        if (run == 0 || us < best) best = us;
+    }
+    return best;
+}
+
+SearchResult search(const Target& target, const SearchOptions& options,
+                    const std::function<void(int, double)>& progress) {
+    SearchResult result;
+    if (options.n == 0) return result;
+
+    // Timed scores would compete for cores, so that objective runs on one
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (options.objective == Objective::Time) threads = 1;
+    std::mt19937 rng(options.seed);
+
+    struct Scored {
+        std::vector<int> input;
+        double score;
+    };
+    auto scoreAll = [&](std::vector<Scored>& candidates) {
+        forEachParallel(candidates.size(), threads, [&](size_t i) {
+            candidates[i].score = score(target, candidates[i].input, options.objective);
+        });
+        result.evaluations += static_cast<long long>(candidates.size());
+    };
+
+    std::vector<Scored> parents;
+    for (int i = 0; i < std::max(1, options.population); i++) {
+        parents.push_back({randomCandidate(target, options.n, rng), 0.0});
+    }
+    scoreAll(parents);
+    std::vector<double> randomScores;
+    for (const Scored& parent : parents) randomScores.push_back(parent.score);
+    std::sort(randomScores.begin(), randomScores.end());
+    result.randomScore = randomScores[randomScores.size() / 2];
+
+    // Seeds replace random parents from the back, after the random median
+    // has been taken
+    std::vector<Scored> seeded;
+    result.method = "evolve";
+    if (options.seedWithExtremes) {
+        for (std::vector<int>& extreme : extremeCandidates(target, options.n)) seeded.push_back({std::move(extreme), 0.0});
+        result.method = target.permutation ? "sorted+reversed+evolve" : "piled+evolve";
+    }
+    if (options.seedWithAntiqsort) {
+        std::vector<int> killer = antiqsort(target, options.n);
+        if (!killer.empty()) {
+            seeded.insert(seeded.begin(), {std::move(killer), 0.0});
+            result.method = "antiqsort+" + result.method;
+        }
+    }
+    seeded.resize(std::min(seeded.size(), parents.size()));
+    scoreAll(seeded);
+    std::move(seeded.begin(), seeded.end(), parents.end() - seeded.size());
+
+    auto byScore = [](const Scored& a, const Scored& b) { return a.score > b.score; };
+    std::stable_sort(parents.begin(), parents.end(), byScore);
+
+    for (int generation = 0; generation < options.generations; generation++) {
+        // Mutants are drawn on this thread so a seed gives the same search
+        // whatever the thread count
+        std::vector<Scored> children;
+        std::uniform_int_distribution<size_t> pickParent(0, parents.size() - 1);
+        std::uniform_int_distribution<int> mutationCount(1, 3);
+        for (int c = 0; c < options.offspring; c++) {
+            Scored child{parents[pickParent(rng)].input, 0.0};
+            for (int m = mutationCount(rng); m > 0; m--) mutate(target, child.input, rng);
+            children.push_back(std::move(child));
+        }
+        scoreAll(children);
+
+        // Children go first so ties move the population across plateaus
+        children.insert(children.end(), parents.begin(), parents.end());
+        std::stable_sort(children.begin(), children.end(), byScore);
+        children.resize(parents.size());
+        parents = std::move(children);
+
+        result.generations = generation + 1;
+        if (progress) progress(generation, parents.front().score);
+    }
+
+    result.worst = parents.front().input;
+    result.worstScore = parents.front().score;
+    return result;
+}
+
+bool saveDataset(const std::string& path, const Dataset& dataset) {
+    std::filesystem::path file(path);
+    if (file.has_parent_path()) {
+        std::error_code ignored;
+        std::filesystem::create_directories(file.parent_path(), ignored);
+    }
+    std::ofstream out(path);
+    out << "# worst-case input found by adversary; key = value / scale\n"
+        << "target " << dataset.target << "\n"
+        << "objective " << dataset.objective << "\n"
+        << "method " << dataset.method << "\n"
+        << "score " << dataset.score << "\n"
+        << "random " << dataset.randomScore << "\n"
+        << "seed " << dataset.seed << "\n"
+        << "scale " << dataset.scale << "\n"
+        << "n " << dataset.values.size() << "\n"
+        << "values\n";
+    for (size_t i = 0; i < dataset.values.size(); i++) {
+        out << dataset.values[i] << ((i + 1) % 16 == 0 || i + 1 == dataset.values.size() ? "\n" : " ");
+    }
+    return static_cast<bool>(out);
+}
+
+bool loadDataset(const std::string& path, Dataset& dataset, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    dataset = Dataset();
+    size_t n = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key == "target") fields >> dataset.target;
+        else if (key == "objective") fields >> dataset.objective;
+        else if (key == "method") fields >> dataset.method;
+        else if (key == "score") fields >> dataset.score;
+        else if (key == "random") fields >> dataset.randomScore;
+        else if (key == "seed") fields >> dataset.seed;
+        else if (key == "scale") fields >> dataset.scale;
+        else if (key == "n") fields >> n;
+        else if (key == "values") break;
+    }
+    int value;
+    while (in >> value) dataset.values.push_back(value);
+
+    if (dataset.values.size() != n) {
+        error = path + ": expected " + std::to_string(n) + " values, found " + std::to_string(dataset.values.size());
+        return false;
+    }
+    if (dataset.scale <= 0) {
+        error = path + ": scale must be positive";
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> listDatasets(const std::string& directory) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt") paths.push_back(entry.path().string());
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace adversary
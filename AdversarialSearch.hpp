@@ -0,0 +1,99 @@
+#pragma once
+
+#ifndef ADVERSARIAL_SEARCH_HPP
+#define ADVERSARIAL_SEARCH_HPP
+
+#include <vector>
+#include <string>
+#include <functional>
+
+// Worst-case input search. Candidates are scored with a counting tracer:
+// each target re-runs its algorithm's exact comparison sequence with a
+// counter in place of the visual callbacks, so thousands of candidates can
+// be tried per second and scored on several threads at once.
+//
+//   quickSort   Lomuto partition around the last element, as the visualizer's quickSort
+//   std::sort   introsort (the Introsort dispatcher choice)
+//   bucketSort  n buckets by floor(x * n), each sorted with std::sort; keys are value / kBucketScale
+namespace adversary {
+
+constexpr int kBucketScale = 1 << 20;
+
+enum class Objective { Comparisons, Time };
+
+struct Target {
+    std::string name;
+    bool permutation;   // candidates are permutations of 0..n-1; otherwise values in [0, kBucketScale)
+    // Comparisons made sorting `input`
+    std::function<long long(const std::vector<int>&)> comparisons;
+    // Sorts `items` using only `less`; empty when the algorithm is not
+    // comparison-driven, which rules out antiqsort
+    std::function<void(std::vector<int>&, const std::function<bool(int, int)>&)> sortWith;
+};
+
+const std::vector<Target>& targets();
+const Target* findTarget(const std::string& name);
+
+// McIlroy's adversary ("A Killer Adversary for Quicksort", 1999): values
+// are fixed lazily while the sort runs, always in the way that keeps the
+// current pivot candidate extreme. Returns the input that replays the
+// resulting comparison sequence, or an empty vector without sortWith.
+std::vector<int> antiqsort(const Target& target, size_t n);
+
+// Score of one input: comparisons, or the best of three runs in microseconds
+double score(const Target& target, const std::vector<int>& input, Objective objective);
+
+struct SearchOptions {
+    size_t n = 16;
+    Objective objective = Objective::Comparisons;
+    int generations = 200;
+    int population = 8;       // parents kept per generation
+    int offspring = 32;       // mutants scored per generation
+    unsigned threads = 0;     // 0: every hardware thread
+    unsigned seed = 1;
+    bool seedWithAntiqsort = true;
+    bool seedWithExtremes = true;  // sorted and reversed inputs, or keys piled into one bucket
+};
+
+struct SearchResult {
+    std::vector<int> worst;
+    double worstScore = 0.0;
+    double randomScore = 0.0;   // median over a few random inputs, for scale
+    int generations = 0;
+    long long evaluations = 0;
+    std::string method;
+};
+
+// (mu + lambda) evolution, i.e. parallel hill climbing: every generation
+// mutates the current parents (swaps, element moves, segment reversals and
+// rotations for permutations, value resets and clustering for bucket keys),
+// scores the mutants across threads and keeps the best. The population
+// starts random, with the antiqsort input and the extreme inputs (sorted,
+// reversed, or piled keys) in place of some parents, so the search never
+// ends below them. Deterministic for a seed.
+// `progress` is called after each generation with the best score so far.
+SearchResult search(const Target& target, const SearchOptions& options,
+                    const std::function<void(int, double)>& progress = {});
+
+// Reproducible input saved by the search, readable by the visualizer (D)
+// and the benchmark (--dataset)
+struct Dataset {
+    std::string target;
+    std::string objective;
+    std::string method;
+    double score = 0.0;
+    double randomScore = 0.0;
+    unsigned seed = 0;
+    int scale = 1;            // keys are values / scale (kBucketScale for bucketSort)
+    std::vector<int> values;
+};
+
+bool saveDataset(const std::string& path, const Dataset& dataset);
+bool loadDataset(const std::string& path, Dataset& dataset, std::string& error);
+
+// Dataset files (*.txt) in a directory, sorted by name
+std::vector<std::string> listDatasets(const std::string& directory);
+
+} // namespace adversary
+
+#endif // ADVERSARIAL_SEARCH_HPP
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef LOMUTO_PARTITION_HPP
+#define LOMUTO_PARTITION_HPP
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Lomuto partition of arr[low, high] around the pivot arr[high]: values
+// smaller than the pivot are swapped to the front in scan order and the
+// pivot lands right after them. Every QuickSort and select in the tree
+// partitions through here, so they all make the same comparisons.
+//
+// LomutoScan is the same loop one comparison at a time, for callers that
+// stop in between (the visual QuickSort yields a step after each one).
+struct LomutoScan {
+    int high;
+    int pivot;
+    int last;  // end of the smaller-than-pivot prefix, low - 1 while empty
+    int next;  // index the following step() compares
+
+    LomutoScan(const std::vector<int>& arr, int low, int high)
+        : high(high), pivot(arr[high]), last(low - 1), next(low) {}
+
+    bool done() const { return next >= high; }
+
+    // Compares arr[next] with the pivot and moves it into the prefix when
+    // smaller. True if that took a swap (the value was not already there).
+    template <typename Less = std::less<int>>
+    bool step(std::vector<int>& arr, const Less& less = Less()) {
+        int j = next++;
+        if (!less(arr[j], pivot)) return false;
+        if (++last == j) return false;
+        std::swap(arr[last], arr[j]);
+        return true;
+    }
+
+    // Swaps the pivot in after the prefix; true if it had to move
+    bool finish(std::vector<int>& arr) {
+        if (last + 1 == high) return false;
+        std::swap(arr[last + 1], arr[high]);
+        return true;
+    }
+
+    int pivotIndex() const { return last + 1; }
+};
+
+// Returns the pivot's final index. `less` is called exactly once per
+// element of arr[low, high), which is what the adversary counts.
+template <typename Less>
+int lomutoPartition(std::vector<int>& arr, int low, int high, const Less& less) {
+    LomutoScan scan(arr, low, high);
+    while (!scan.done()) scan.step(arr, less);
+    scan.finish(arr);
+    return scan.pivotIndex();
+}
+
+inline int lomutoPartition(std::vector<int>& arr, int low, int high) {
+    return lomutoPartition(arr, low, high, std::less<int>());
+}
+
+#endif // LOMUTO_PARTITION_HPP
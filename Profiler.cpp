@@ -0,0 +1,243 @@
+#include "Profiler.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace profiler {
+
+namespace {
+
+struct SpanRecord {
+    const char* name;
+    const char* category;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+// Single writer (the owning thread); the exporter reads [0, count)
+struct ThreadBuffer {
+    static constexpr size_t kCapacity = 1 << 16;
+
+    explicit ThreadBuffer(uint32_t tid) : records(kCapacity), tid(tid) {}
+
+    std::vector<SpanRecord> records;
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> dropped{0};
+    uint32_t tid;
+};
+
+std::atomic<bool> enabled{false};
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+std::vector<ThreadBuffer*> freeBuffers;  // owned by registry, their threads have exited
+
+const auto processStart = std::chrono::steady_clock::now();
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - processStart).count();
+}
+
+// A thread's claim on a buffer. On thread exit the buffer goes back on the
+// free list, where the next new thread picks it up and appends after the
+// spans already in it, so short-lived sort workers reuse the same few
+// buffers instead of registering a fresh 2 MB one each.
+struct BufferLease {
+    ThreadBuffer* buffer = nullptr;
+
+    ~BufferLease() {
+        if (!buffer) return;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        freeBuffers.push_back(buffer);
+    }
+};
+
+// Buffers are owned by the registry so spans survive their thread
+ThreadBuffer& threadBuffer() {
+    thread_local BufferLease lease;
+    if (!lease.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (!freeBuffers.empty()) {
+            lease.buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+        } else {
+            registry.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(registry.size() + 1)));
+            lease.buffer = registry.back().get();
+        }
+    }
+    return *lease.buffer;
+}
+
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') out << '\\';
+        out << *p;
+    }
+    out << '"';
+}
+
+} // namespace
+
+void setEnabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+bool isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : registry) {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t spanCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t total = 0;
+    for (auto& buffer : registry) total += buffer->count.load(std::memory_order_acquire);
+    return total;
+}
+
+size_t droppedCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t total = 0;
+    for (auto& buffer : registry) total += buffer->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+bool writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    out << std::fixed << std::setprecision(3);
+    for (auto& buffer : registry) {
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const SpanRecord& r = buffer->records[i];
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(out, r.name);
+            out << ",\"cat\":";
+            writeJsonString(out, r.category);
+            out << ",\"ph\":\"X\",\"ts\":" << r.startNs / 1000.0
+                << ",\"dur\":" << r.durationNs / 1000.0
+                << ",\"pid\":1,\"tid\":" << buffer->tid << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+double processCpuMs() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0.0;
+    auto toMs = [](const FILETIME& time) {
+        ULARGE_INTEGER ticks;
+        ticks.LowPart = time.dwLowDateTime;
+        ticks.HighPart = time.dwHighDateTime;
+        return ticks.QuadPart / 10000.0;  // 100 ns units
+    };
+    return toMs(kernel) + toMs(user);
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    auto toMs = [](const timeval& time) { return time.tv_sec * 1000.0 + time.tv_usec / 1000.0; };
+    return toMs(usage.ru_utime) + toMs(usage.ru_stime);
+#endif
+}
+
+#ifdef __linux__
+HardwareCounter::HardwareCounter(HardwareEvent event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    if (event == HardwareEvent::CacheMisses) {
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    } else {
+        // Generic cache events: cache id | operation << 8 | result << 16
+        unsigned long long cache = event == HardwareEvent::L1DataReadMisses ? PERF_COUNT_HW_CACHE_L1D
+                                                                            : PERF_COUNT_HW_CACHE_DTLB;
+        unsigned long long operation = event == HardwareEvent::DataTlbStoreMisses ? PERF_COUNT_HW_CACHE_OP_WRITE
+                                                                                  : PERF_COUNT_HW_CACHE_OP_READ;
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = cache | (operation << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+HardwareCounter::~HardwareCounter() {
+    if (fd >= 0) close(fd);
+}
+
+void HardwareCounter::start() {
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+long long HardwareCounter::stop() {
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long count = 0;
+    if (read(fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return -1;
+    return count;
+}
+#else
+HardwareCounter::HardwareCounter(HardwareEvent) {}
+HardwareCounter::~HardwareCounter() {}
+void HardwareCounter::start() {}
+long long HardwareCounter::stop() { return -1; }
+#endif
+
+ScopedSpan::ScopedSpan(const char* name, const char* category)
+    : name(name), category(category), startNs(0), active(isEnabled()) {
+    if (active) startNs = nowNs();
+}
+
+void ScopedSpan::end() {
+    if (!active) return;
+    active = false;
+
+    int64_t endNs = nowNs();
+    ThreadBuffer& buffer = threadBuffer();
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= ThreadBuffer::kCapacity) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.records[index] = {name, category, startNs, endNs - startNs};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+} // namespace profiler
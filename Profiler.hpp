@@ -0,0 +1,79 @@
+#pragma once
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <cstdint>
+#include <string>
+
+// Lightweight span recorder exported as Chrome trace-event JSON (open the
+// file in Perfetto or chrome://tracing). Each thread appends to its own
+// fixed-size buffer without locking (a buffer is handed on to a new thread
+// once its owner exits); recording is off until setEnabled(true) and a
+// disabled span costs one relaxed atomic load.
+//
+//   profiler::ScopedSpan span("scatter pass", "sort");
+//
+// Names and categories must be string literals: only the pointer is stored.
+namespace profiler {
+
+void setEnabled(bool enabled);
+bool isEnabled();
+
+// Drops recorded spans; call only while no other thread is recording
+void reset();
+size_t spanCount();
+size_t droppedCount();
+
+bool writeChromeTrace(const std::string& path);
+
+// CPU time consumed by the whole process so far (all threads, user + system)
+double processCpuMs();
+
+// Counts one hardware event for the calling thread between start() and
+// stop(), via perf_event_open on Linux (user space only, so the default
+// perf_event_paranoid of 2 suffices). Where there is no such counter
+// (other platforms, VMs without a PMU) available() is false and stop()
+// returns -1.
+enum class HardwareEvent {
+    CacheMisses,        // last-level cache misses
+    L1DataReadMisses,
+    DataTlbLoadMisses,
+    DataTlbStoreMisses  // not counted by every CPU (e.g. many AMD parts)
+};
+
+class HardwareCounter {
+public:
+    explicit HardwareCounter(HardwareEvent event);
+    ~HardwareCounter();
+    HardwareCounter(const HardwareCounter&) = delete;
+    HardwareCounter& operator=(const HardwareCounter&) = delete;
+
+    bool available() const { return fd >= 0; }
+    void start();
+    long long stop();
+
+private:
+    int fd = -1;
+};
+
+class ScopedSpan {
+public:
+    explicit ScopedSpan(const char* name, const char* category = "sort");
+    ~ScopedSpan() { end(); }
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    // Closes the span early; later calls (and the destructor) do nothing
+    void end();
+
+private:
+    const char* name;
+    const char* category;
+    int64_t startNs;
+    bool active;
+};
+
+} // namespace profiler
+
+#endif // PROFILER_HPP
@@ -1,385 +1,2549 @@
-#include "SortAlgorithms.hpp"
-#include <vector>
-#include <algorithm>
-#include <sstream>
-#include <iomanip>
-#include <thread>
-#include <chrono>
-#include <cmath>
-
-void sleepForVisualization(float speedMultiplier) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / speedMultiplier)));
-}
-
-std::string formatFloatArray(const std::vector<float>& arr) {
-    std::ostringstream oss;
-    for (size_t i = 0; i < arr.size(); ++i) {
-        if (i != 0) oss << ", ";
-        oss << std::fixed << std::setprecision(2) << arr[i];
-    }
-    return oss.str();
-}
-
-void bubbleSort(std::vector<int>& arr, 
-               std::function<void(const std::vector<int>&, int, int, const std::string&)> callback) {
-    SortStats stats;
-    stats.timeComplexity = "O(n^2)";
-    stats.spaceComplexity = "O(1)";
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    int n = arr.size();
-    for (int i = 0; i < n - 1; ++i) {
-        for (int j = 0; j < n - i - 1; ++j) {
-            stats.comparisons++;
-            callback(arr, j, j + 1, "Comparing elements\nComparisons: " + std::to_string(stats.comparisons));
-            if (arr[j] > arr[j + 1]) {
-                std::swap(arr[j], arr[j + 1]);
-                stats.swaps++;
-                callback(arr, j, j + 1, "Swapped elements\nComparisons: " + std::to_string(stats.comparisons) + 
-                                      "\nSwaps: " + std::to_string(stats.swaps));
-            }
-        }
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
-    callback(arr, -1, -1, "Bubble Sort Complete\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
-                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                         "Swaps: " + std::to_string(stats.swaps) + "\n" +
-                         "Time Complexity: " + stats.timeComplexity + "\n" +
-                         "Space Complexity: " + stats.spaceComplexity);
-}
-
-void insertionSort(std::vector<int>& arr,
-                 std::function<void(const std::vector<int>&, int, int, const std::string&)> callback) {
-    SortStats stats;
-    stats.timeComplexity = "O(n^2)";
-    stats.spaceComplexity = "O(1)";
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    int n = arr.size();
-    for (int i = 1; i < n; ++i) {
-        int key = arr[i];
-        int j = i - 1;
-
-        stats.comparisons++;
-        callback(arr, i, j, "Picked element " + std::to_string(key) + 
-                           "\nComparisons: " + std::to_string(stats.comparisons));
-
-        while (j >= 0 && arr[j] > key) {
-            stats.comparisons++;
-            arr[j + 1] = arr[j];
-            stats.swaps++;
-            callback(arr, j, j + 1, "Shifting " + std::to_string(arr[j]) + " right\n" +
-                                    "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                                    "Shifts: " + std::to_string(stats.swaps));
-            j--;
-        }
-
-        arr[j + 1] = key;
-        callback(arr, j + 1, i, "Inserted " + std::to_string(key) + " at position " + 
-                                std::to_string(j + 1) + "\nComparisons: " + 
-                                std::to_string(stats.comparisons) + "\nShifts: " + 
-                                std::to_string(stats.swaps));
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
-    callback(arr, -1, -1, "Insertion Sort Completed!\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
-                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                         "Shifts: " + std::to_string(stats.swaps) + "\n" +
-                         "Time Complexity: " + stats.timeComplexity + "\n" +
-                         "Space Complexity: " + stats.spaceComplexity);
-}
-
-void quickSort(std::vector<int>& arr, VisualizerState& state, int low, int high, bool isInitialCall) {
-    static SortStats stats;
-    static std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
-    
-    if (isInitialCall) {
-        stats = SortStats();
-        stats.timeComplexity = "O(n log n) avg, O(n^2) worst";
-        stats.spaceComplexity = "O(log n)";
-        startTime = std::chrono::high_resolution_clock::now();
-    }
-
-    if (low < high) {
-        int pivot = arr[high];
-        int i = low - 1;
-
-        QuickSortStep step;
-        step.array = arr;
-        step.pivotIndex = high;
-        step.comparingIndex = -1;
-        step.leftBound = low;
-        step.rightBound = high;
-        step.explanation = "Selecting pivot: " + std::to_string(pivot) + " (index " + 
-                          std::to_string(high) + ")\nComparisons: " + 
-                          std::to_string(stats.comparisons);
-        state.quickSortSteps.push_back(step);
-
-        for (int j = low; j < high; ++j) {
-            stats.comparisons++;
-            step.array = arr;
-            step.pivotIndex = high;
-            step.comparingIndex = j;
-            step.leftBound = low;
-            step.rightBound = high;
-            step.explanation = "Comparing " + std::to_string(arr[j]) + " with pivot (" + 
-                              std::to_string(pivot) + ")\nComparisons: " + 
-                              std::to_string(stats.comparisons);
-            state.quickSortSteps.push_back(step);
-
-            if (arr[j] < pivot) {
-                i++;
-                if (i != j) {
-                    std::swap(arr[i], arr[j]);
-                    stats.swaps++;
-                    step.array = arr;
-                    step.explanation = "Swapped " + std::to_string(arr[i]) + " and " + 
-                                      std::to_string(arr[j]) + "\nComparisons: " + 
-                                      std::to_string(stats.comparisons) + "\nSwaps: " + 
-                                      std::to_string(stats.swaps);
-                    state.quickSortSteps.push_back(step);
-                }
-            }
-        }
-
-        if (i + 1 != high) {
-            std::swap(arr[i + 1], arr[high]);
-            stats.swaps++;
-            step.array = arr;
-            step.pivotIndex = i + 1;
-            step.comparingIndex = -1;
-            step.leftBound = low;
-            step.rightBound = high;
-            step.explanation = "Moved pivot to final position at index " + 
-                              std::to_string(i + 1) + "\nComparisons: " + 
-                              std::to_string(stats.comparisons) + "\nSwaps: " + 
-                              std::to_string(stats.swaps);
-            state.quickSortSteps.push_back(step);
-        }
-        int pivotPos = i + 1;
-
-        step.array = arr;
-        step.pivotIndex = pivotPos;
-        step.comparingIndex = -1;
-        step.leftBound = low;
-        step.rightBound = high;
-        if (low < pivotPos)
-            step.leftPartition = std::vector<int>(arr.begin() + low, arr.begin() + pivotPos);
-        if (pivotPos + 1 < high)
-            step.rightPartition = std::vector<int>(arr.begin() + pivotPos + 1, arr.begin() + high + 1);
-        step.explanation = "Partitioned: left (" + std::to_string(low) + "-" + 
-                          std::to_string(pivotPos-1) + "), right (" + 
-                          std::to_string(pivotPos+1) + "-" + std::to_string(high) + ")\n" +
-                          "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                          "Swaps: " + std::to_string(stats.swaps);
-        state.quickSortSteps.push_back(step);
-
-        quickSort(arr, state, low, pivotPos - 1, false);
-        quickSort(arr, state, pivotPos + 1, high, false);
-
-        if (isInitialCall) {
-            auto endTime = std::chrono::high_resolution_clock::now();
-            stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
-            step.array = arr;
-            step.pivotIndex = -1;
-            step.comparingIndex = -1;
-            step.leftBound = -1;
-            step.rightBound = -1;
-            step.leftPartition.clear();
-            step.rightPartition.clear();
-            step.explanation = "QuickSort Complete!\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
-                              "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                              "Swaps: " + std::to_string(stats.swaps) + "\n" +
-                              "Time Complexity: " + stats.timeComplexity + "\n" +
-                              "Space Complexity: " + stats.spaceComplexity;
-            state.quickSortSteps.push_back(step);
-        }
-    }
-}
-
-void bucketSort(std::vector<float>& arr,
-               SortStats& stats,
-               VisualizerState& state,
-               std::function<void(const std::vector<std::vector<float>>&, const std::string&)> stepCallback) {
-    stats = SortStats();
-    stats.timeComplexity = "O(n + k) average";
-    stats.spaceComplexity = "O(n + k)";
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    int n = arr.size();
-    if (n <= 0) return;
-
-    std::vector<std::vector<float>> buckets(n);
-    for (int i = 0; i < n; ++i) {
-        int index = static_cast<int>(arr[i] * n);
-        if (index == n) index = n - 1;
-        buckets[index].push_back(arr[i]);
-        stats.swaps++;
-
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(2) 
-            << "Placing " << arr[i] << " into bucket " << index << "\n"
-            << "Operations: " << stats.swaps;
-        stepCallback(buckets, oss.str());
-        sleepForVisualization(state.speed);
-    }
-
-    for (int i = 0; i < n; ++i) {
-        if (!buckets[i].empty()) {
-            std::sort(buckets[i].begin(), buckets[i].end());
-            stats.comparisons += buckets[i].size() * log2(buckets[i].size());
-            stats.swaps += buckets[i].size() * log2(buckets[i].size());
-            
-            std::ostringstream oss;
-            oss << "Sorting bucket " << i << " (" << buckets[i].size() << " elements)\n"
-                << "Comparisons: ~" << stats.comparisons << "\n"
-                << "Operations: " << stats.swaps;
-            stepCallback(buckets, oss.str());
-            sleepForVisualization(state.speed);
-        }
-    }
-
-    int index = 0;
-    for (const auto& bucket : buckets) {
-        for (float val : bucket) {
-            arr[index++] = val;
-            stats.swaps++;
-        }
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
-    
-    stepCallback(buckets, "Final sorted array constructed\nTime: " + 
-                         std::to_string(stats.timeTaken) + "ms\n" +
-                         "Comparisons: ~" + std::to_string(stats.comparisons) + "\n" +
-                         "Operations: " + std::to_string(stats.swaps) + "\n" +
-                         "Time Complexity: " + stats.timeComplexity + "\n" +
-                         "Space Complexity: " + stats.spaceComplexity);
-    sleepForVisualization(state.speed);
-
-    state.array.clear();
-    for (float val : arr) {
-        state.array.push_back(static_cast<int>(val * 100));
-    }
-    state.currentStep = "Final Sorted Array: [" + formatFloatArray(arr) + "]";
-    state.highlightedIndex = -1;
-    state.secondaryIndex = -1;
-}
-
-void radixSort(std::vector<int>& arr,
-              std::function<void(const std::vector<int>&, int, int, const std::string&)> callback) {
-    if (arr.empty()) return;
-
-    SortStats stats;
-    stats.timeComplexity = "O(nk)";
-    stats.spaceComplexity = "O(n + k)";
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    int maxNum = *std::max_element(arr.begin(), arr.end());
-    for (int exp = 1; maxNum / exp > 0; exp *= 10) {
-        std::vector<int> output(arr.size());
-        std::vector<int> count(10, 0);
-        
-        for (size_t i = 0; i < arr.size(); i++) {
-            int digit = (arr[i] / exp) % 10;
-            count[digit]++;
-            stats.comparisons++;
-            callback(arr, i, -1, "Counting digit " + std::to_string(digit) + 
-                                " at position " + std::to_string(i) + "\n" +
-                                "Comparisons: " + std::to_string(stats.comparisons));
-        }
-        
-        for (int i = 1; i < 10; i++) {
-            count[i] += count[i - 1];
-            callback(arr, -1, -1, "Calculating cumulative count for digit " + 
-                                  std::to_string(i) + "\nComparisons: " + 
-                                  std::to_string(stats.comparisons));
-        }
-        
-        for (int i = arr.size() - 1; i >= 0; i--) {
-            int digit = (arr[i] / exp) % 10;
-            output[count[digit] - 1] = arr[i];
-            count[digit]--;
-            stats.swaps++;
-            callback(arr, i, -1, "Placing " + std::to_string(arr[i]) + 
-                                " in output array\nOperations: " + 
-                                std::to_string(stats.swaps));
-        }
-        
-        for (size_t i = 0; i < arr.size(); i++) {
-            arr[i] = output[i];
-            callback(arr, i, -1, "Updating array with sorted digits (exp=" + 
-                                std::to_string(exp) + ")\nOperations: " + 
-                                std::to_string(stats.swaps));
-        }
-    }
-    
-    auto endTime = std::chrono::high_resolution_clock::now();
-    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
-    callback(arr, -1, -1, "Radix Sort Complete!\nTime: " + 
-                         std::to_string(stats.timeTaken) + "ms\n" +
-                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                         "Operations: " + std::to_string(stats.swaps) + "\n" +
-                         "Time Complexity: " + stats.timeComplexity + "\n" +
-                         "Space Complexity: " + stats.spaceComplexity);
-}
-
-void countingSort(std::vector<int>& arr,
-                std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
-                VisualizerState& state) {
-    if (arr.empty()) return;
-
-    SortStats stats;
-    stats.timeComplexity = "O(n + k)";
-    stats.spaceComplexity = "O(n + k)";
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    int max = *std::max_element(arr.begin(), arr.end());
-    std::vector<int> count(max + 1, 0);
-    std::vector<int> output(arr.size());
-
-    for (size_t i = 0; i < arr.size(); i++) {
-        count[arr[i]]++;
-        stats.comparisons++;
-        state.countArray = count;
-        callback(arr, i, -1, "Counting occurrence of " + std::to_string(arr[i]) + 
-                            "\nComparisons: " + std::to_string(stats.comparisons));
-    }
-
-    for (size_t i = 1; i < count.size(); i++) {
-        count[i] += count[i - 1];
-        state.countArray = count;
-        callback(arr, -1, -1, "Calculating cumulative count for value " + 
-                              std::to_string(i) + "\nComparisons: " + 
-                              std::to_string(stats.comparisons));
-    }
-
-    for (int i = arr.size() - 1; i >= 0; i--) {
-        output[count[arr[i]] - 1] = arr[i];
-        count[arr[i]]--;
-        stats.swaps++;
-        state.countArray = count;
-        callback(arr, i, -1, "Placing " + std::to_string(arr[i]) + 
-                            " in output array\nOperations: " + 
-                            std::to_string(stats.swaps));
-    }
-
-    for (size_t i = 0; i < arr.size(); i++) {
-        arr[i] = output[i];
-        callback(arr, i, -1, "Updating main array with sorted elements\nOperations: " + 
-                            std::to_string(stats.swaps));
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
-    callback(arr, -1, -1, "Counting Sort Complete!\nTime: " + 
-                         std::to_string(stats.timeTaken) + "ms\n" +
-                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                         "Operations: " + std::to_string(stats.swaps) + "\n" +
-                         "Time Complexity: " + stats.timeComplexity + "\n" +
-                         "Space Complexity: " + stats.spaceComplexity);
-}
\ No newline at end of file
+#include "SortAlgorithms.hpp"
+#include "Profiler.hpp"
+#include "SortMemory.hpp"
+#include "LomutoPartition.hpp"
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <charconv>
+#include <cstring>
+#include <random>
+#include <atomic>
+#include <optional>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SORT_ANALYZER_SSE2 1
+#endif
+
+void sleepForVisualization(float speedMultiplier) {
+    profiler::ScopedSpan span("sleep_for", "callback");
+    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / speedMultiplier)));
+}
+
+std::string formatFloatArray(const std::vector<float>& arr) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < arr.size(); ++i) {
+        if (i != 0) oss << ", ";
+        oss << std::fixed << std::setprecision(2) << arr[i];
+    }
+    return oss.str();
+}
+
+namespace {
+
+// A number printed with a fixed count of decimals
+struct Fixed {
+    double value;
+    int precision;
+};
+
+// Builds a step's text in place: into the step's memory resource for
+// QuickSort records, or into one string per sort that keeps its capacity,
+// so a narrated step stops costing a chain of heap-allocated temporaries
+template <typename String>
+void appendPart(String& out, const char* text) { out += text; }
+template <typename String>
+void appendPart(String& out, const std::string& text) { out.append(text.data(), text.size()); }
+template <typename String>
+void appendPart(String& out, Fixed number) {
+    char digits[64];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number.value,
+                                std::chars_format::fixed, number.precision);
+    if (result.ec == std::errc()) out.append(digits, result.ptr);
+    else out += std::to_string(number.value).c_str();
+}
+// Same six decimals as std::to_string
+template <typename String>
+void appendPart(String& out, double value) { appendPart(out, Fixed{value, 6}); }
+template <typename String, typename Int,
+          std::enable_if_t<std::is_integral_v<Int> && !std::is_same_v<Int, char> && !std::is_same_v<Int, bool>, int> = 0>
+void appendPart(String& out, Int value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+template <typename String, typename... Parts>
+const String& setExplanation(String& out, const Parts&... parts) {
+    out.clear();
+    (appendPart(out, parts), ...);
+    return out;
+}
+
+} // namespace
+
+void bubbleSort(std::vector<int>& arr, 
+               std::function<void(const std::vector<int>&, int, int, const std::string&)> callback) {
+    SortStats stats;
+    stats.timeComplexity = "O(n^2)";
+    stats.spaceComplexity = "O(1)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    int n = arr.size();
+    std::string text;
+    for (int i = 0; i < n - 1; ++i) {
+        for (int j = 0; j < n - i - 1; ++j) {
+            stats.comparisons++;
+            callback(arr, j, j + 1, setExplanation(text, "Comparing elements\nComparisons: ", stats.comparisons));
+            if (arr[j] > arr[j + 1]) {
+                std::swap(arr[j], arr[j + 1]);
+                stats.swaps++;
+                callback(arr, j, j + 1, setExplanation(text, "Swapped elements\nComparisons: ", stats.comparisons,
+                                                       "\nSwaps: ", stats.swaps));
+            }
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, -1, -1, "Bubble Sort Complete\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Swaps: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+void insertionSort(std::vector<int>& arr,
+                 std::function<void(const std::vector<int>&, int, int, const std::string&)> callback) {
+    SortStats stats;
+    stats.timeComplexity = "O(n^2)";
+    stats.spaceComplexity = "O(1)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    int n = arr.size();
+    std::string text;
+    for (int i = 1; i < n; ++i) {
+        int key = arr[i];
+        int j = i - 1;
+
+        stats.comparisons++;
+        callback(arr, i, j, setExplanation(text, "Picked element ", key, "\nComparisons: ", stats.comparisons));
+
+        while (j >= 0 && arr[j] > key) {
+            stats.comparisons++;
+            arr[j + 1] = arr[j];
+            stats.swaps++;
+            callback(arr, j, j + 1, setExplanation(text, "Shifting ", arr[j], " right\nComparisons: ",
+                                                   stats.comparisons, "\nShifts: ", stats.swaps));
+            j--;
+        }
+
+        arr[j + 1] = key;
+        callback(arr, j + 1, i, setExplanation(text, "Inserted ", key, " at position ", j + 1,
+                                               "\nComparisons: ", stats.comparisons, "\nShifts: ", stats.swaps));
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, -1, -1, "Insertion Sort Completed!\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Shifts: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+StepGenerator<QuickSortStep> quickSortStepGenerator(std::vector<int> arr, int low, int high,
+                                                    std::pmr::memory_resource* memory) {
+    SortStats stats;
+    stats.timeComplexity = "O(n log n) avg, O(n^2) worst";
+    stats.spaceComplexity = "O(log n)";
+    // Only time spent inside the coroutine counts; the viewer may sit on a
+    // step for minutes between resumptions.
+    double activeMs = 0.0;
+    auto resumedAt = std::chrono::high_resolution_clock::now();
+    // Likewise each partition's "partition" span is closed before every
+    // co_yield and reopened on resumption, so it covers only the work.
+    std::optional<profiler::ScopedSpan> partitionSpan;
+    bool partitioning = false;
+    auto pause = [&]() {
+        partitionSpan.reset();
+        auto now = std::chrono::high_resolution_clock::now();
+        activeMs += std::chrono::duration<double, std::milli>(now - resumedAt).count();
+    };
+    auto resume = [&]() {
+        resumedAt = std::chrono::high_resolution_clock::now();
+        if (partitioning) partitionSpan.emplace("partition");
+    };
+
+    if (low >= high) co_return;
+
+    // Explicit range stack in place of recursion; the left range is pushed
+    // last so steps come out in the same order as the recursive version.
+    std::vector<std::pair<int, int>> ranges{{low, high}};
+    QuickSortStep step(memory);
+    while (!ranges.empty()) {
+        auto [lo, hi] = ranges.back();
+        ranges.pop_back();
+        if (lo >= hi) continue;
+
+        partitioning = true;
+        partitionSpan.emplace("partition");
+        LomutoScan scan(arr, lo, hi);
+
+        step.array.assign(arr.begin(), arr.end());
+        step.pivotIndex = hi;
+        step.comparingIndex = -1;
+        step.leftBound = lo;
+        step.rightBound = hi;
+        step.leftPartition.clear();
+        step.rightPartition.clear();
+        setExplanation(step.explanation, "Selecting pivot: ", scan.pivot, " (index ", hi,
+                       ")\nComparisons: ", stats.comparisons);
+        pause();
+        co_yield step;
+        resume();
+
+        while (!scan.done()) {
+            int j = scan.next;
+            stats.comparisons++;
+            step.array.assign(arr.begin(), arr.end());
+            step.pivotIndex = hi;
+            step.comparingIndex = j;
+            setExplanation(step.explanation, "Comparing ", arr[j], " with pivot (", scan.pivot,
+                           ")\nComparisons: ", stats.comparisons);
+            pause();
+            co_yield step;
+            resume();
+
+            if (scan.step(arr)) {
+                stats.swaps++;
+                step.array.assign(arr.begin(), arr.end());
+                setExplanation(step.explanation, "Swapped ", arr[scan.last], " and ", arr[j],
+                               "\nComparisons: ", stats.comparisons,
+                               "\nSwaps: ", stats.swaps);
+                pause();
+                co_yield step;
+                resume();
+            }
+        }
+
+        int pivotPos = scan.pivotIndex();
+        if (scan.finish(arr)) {
+            stats.swaps++;
+            step.array.assign(arr.begin(), arr.end());
+            step.pivotIndex = pivotPos;
+            step.comparingIndex = -1;
+            setExplanation(step.explanation, "Moved pivot to final position at index ", pivotPos,
+                           "\nComparisons: ", stats.comparisons, "\nSwaps: ",
+                           stats.swaps);
+            pause();
+            co_yield step;
+            resume();
+        }
+        partitioning = false;
+        partitionSpan.reset();
+
+        step.array.assign(arr.begin(), arr.end());
+        step.pivotIndex = pivotPos;
+        step.comparingIndex = -1;
+        if (lo < pivotPos)
+            step.leftPartition.assign(arr.begin() + lo, arr.begin() + pivotPos);
+        if (pivotPos + 1 < hi)
+            step.rightPartition.assign(arr.begin() + pivotPos + 1, arr.begin() + hi + 1);
+        setExplanation(step.explanation, "Partitioned: left (", lo, "-", pivotPos - 1, "), right (",
+                       pivotPos + 1, "-", hi, ")\nComparisons: ",
+                       stats.comparisons, "\nSwaps: ", stats.swaps);
+        pause();
+        co_yield step;
+        resume();
+
+        ranges.emplace_back(pivotPos + 1, hi);
+        ranges.emplace_back(lo, pivotPos - 1);
+    }
+
+    pause();
+    stats.timeTaken = activeMs;
+    step.array.assign(arr.begin(), arr.end());
+    step.pivotIndex = -1;
+    step.comparingIndex = -1;
+    step.leftBound = -1;
+    step.rightBound = -1;
+    step.leftPartition.clear();
+    step.rightPartition.clear();
+    setExplanation(step.explanation, "QuickSort Complete!\nTime: ", stats.timeTaken,
+                   "ms\nComparisons: ", stats.comparisons, "\nSwaps: ", stats.swaps,
+                   "\nTime Complexity: ", stats.timeComplexity,
+                   "\nSpace Complexity: ", stats.spaceComplexity);
+    co_yield step;
+}
+
+void quickSort(std::vector<int>& arr, VisualizerState& state, int low, int high, bool isInitialCall) {
+    profiler::ScopedSpan span("quickSort");
+    auto steps = quickSortStepGenerator(arr, low, high, state.memory);
+    while (auto step = steps.next()) {
+        if (!isInitialCall && step->pivotIndex < 0) break;  // completion summary
+        arr.assign(step->array.begin(), step->array.end());
+        state.quickSortSteps.push_back(*step);
+    }
+}
+
+void quickSort(std::vector<int>& arr) {
+    std::vector<std::pair<int, int>> ranges;
+    ranges.emplace_back(0, static_cast<int>(arr.size()) - 1);
+    while (!ranges.empty()) {
+        auto [low, high] = ranges.back();
+        ranges.pop_back();
+        if (low >= high) continue;
+        int p = lomutoPartition(arr, low, high);
+        // Left range on top, so ranges are finished in the visual order
+        ranges.emplace_back(p + 1, high);
+        ranges.emplace_back(low, p - 1);
+    }
+}
+
+void bucketSort(std::vector<float>& arr,
+               SortStats& stats,
+               VisualizerState& state,
+               std::function<void(const BucketList&, const std::string&)> stepCallback) {
+    stats = SortStats();
+    stats.timeComplexity = "O(n + k) average";
+    stats.spaceComplexity = "O(n + k)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    int n = arr.size();
+    if (n <= 0) return;
+
+    // Buckets live in the state so the callback can show them without a
+    // per-step deep copy; bucketFill tracks their sizes for large n
+    BucketList& buckets = state.bucketData;
+    buckets.assign(n, {});
+    state.bucketFill.reset(n);
+    std::string text;
+    profiler::ScopedSpan scatterSpan("scatter pass");
+    for (int i = 0; i < n; ++i) {
+        int index = static_cast<int>(arr[i] * n);
+        if (index == n) index = n - 1;
+        buckets[index].push_back(arr[i]);
+        state.bucketFill.add(index, 1);
+        stats.swaps++;
+
+        stepCallback(buckets, setExplanation(text, "Placing ", Fixed{arr[i], 2}, " into bucket ", index,
+                                             "\nOperations: ", stats.swaps));
+        sleepForVisualization(state.speed);
+    }
+    scatterSpan.end();
+
+    for (int i = 0; i < n; ++i) {
+        if (!buckets[i].empty()) {
+            profiler::ScopedSpan bucketSpan("bucket sort");
+            std::sort(buckets[i].begin(), buckets[i].end());
+            stats.comparisons += buckets[i].size() * log2(buckets[i].size());
+            stats.swaps += buckets[i].size() * log2(buckets[i].size());
+            
+            stepCallback(buckets, setExplanation(text, "Sorting bucket ", i, " (", buckets[i].size(),
+                                                 " elements)\nComparisons: ~", stats.comparisons,
+                                                 "\nOperations: ", stats.swaps));
+            sleepForVisualization(state.speed);
+        }
+    }
+
+    profiler::ScopedSpan gatherSpan("gather pass");
+    int index = 0;
+    for (const auto& bucket : buckets) {
+        for (float val : bucket) {
+            arr[index++] = val;
+            stats.swaps++;
+        }
+    }
+    gatherSpan.end();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    
+    stepCallback(buckets, "Final sorted array constructed\nTime: " + 
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: ~" + std::to_string(stats.comparisons) + "\n" +
+                         "Operations: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+    sleepForVisualization(state.speed);
+
+    state.array.clear();
+    for (float val : arr) {
+        state.array.push_back(static_cast<int>(val * 100));
+    }
+    state.currentStep = "Final Sorted Array: [" + formatFloatArray(arr) + "]";
+    state.highlightedIndex = -1;
+    state.secondaryIndex = -1;
+}
+
+void radixSort(std::vector<int>& arr,
+              std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+              std::pmr::memory_resource* memory) {
+    if (arr.empty()) return;
+
+    SortStats stats;
+    stats.timeComplexity = "O(nk)";
+    stats.spaceComplexity = "O(n + k)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    int maxNum = *std::max_element(arr.begin(), arr.end());
+    // One output buffer for every digit pass
+    std::pmr::vector<int> output(arr.size(), memory);
+    int count[10];
+    std::string text;
+    for (int exp = 1; maxNum / exp > 0; exp *= 10) {
+        std::fill(std::begin(count), std::end(count), 0);
+        
+        profiler::ScopedSpan countSpan("count pass");
+        for (size_t i = 0; i < arr.size(); i++) {
+            int digit = (arr[i] / exp) % 10;
+            count[digit]++;
+            stats.comparisons++;
+            callback(arr, i, -1, setExplanation(text, "Counting digit ", digit, " at position ", i,
+                                                "\nComparisons: ", stats.comparisons));
+        }
+        countSpan.end();
+        
+        profiler::ScopedSpan prefixSpan("prefix sum");
+        for (int i = 1; i < 10; i++) {
+            count[i] += count[i - 1];
+            callback(arr, -1, -1, setExplanation(text, "Calculating cumulative count for digit ", i,
+                                                 "\nComparisons: ", stats.comparisons));
+        }
+        prefixSpan.end();
+        
+        profiler::ScopedSpan scatterSpan("scatter pass");
+        for (int i = arr.size() - 1; i >= 0; i--) {
+            int digit = (arr[i] / exp) % 10;
+            output[count[digit] - 1] = arr[i];
+            count[digit]--;
+            stats.swaps++;
+            callback(arr, i, -1, setExplanation(text, "Placing ", arr[i], " in output array\nOperations: ",
+                                                stats.swaps));
+        }
+        scatterSpan.end();
+        
+        profiler::ScopedSpan copySpan("copy back");
+        for (size_t i = 0; i < arr.size(); i++) {
+            arr[i] = output[i];
+            callback(arr, i, -1, setExplanation(text, "Updating array with sorted digits (exp=", exp,
+                                                ")\nOperations: ", stats.swaps));
+        }
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, -1, -1, "Radix Sort Complete!\nTime: " + 
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Operations: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+void countingSort(std::vector<int>& arr,
+                std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+                VisualizerState& state) {
+    if (arr.empty()) return;
+
+    SortStats stats;
+    stats.timeComplexity = "O(n + k)";
+    stats.spaceComplexity = "O(n + k)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    int max = *std::max_element(arr.begin(), arr.end());
+    std::pmr::vector<int> count(max + 1, 0, state.memory);
+    std::pmr::vector<int> output(arr.size(), state.memory);
+
+    // Each step changes one count; mirror just that entry into the view and
+    // its binned reduction so large k stays cheap per step
+    state.countArray.assign(count.size(), 0);
+    state.countBins.reset(count.size());
+    auto publishCount = [&](size_t index) {
+        state.countBins.add(index, count[index] - state.countArray[index]);
+        state.countArray[index] = count[index];
+    };
+
+    std::string text;
+    profiler::ScopedSpan countSpan("count pass");
+    for (size_t i = 0; i < arr.size(); i++) {
+        count[arr[i]]++;
+        stats.comparisons++;
+        publishCount(arr[i]);
+        callback(arr, i, -1, setExplanation(text, "Counting occurrence of ", arr[i],
+                                            "\nComparisons: ", stats.comparisons));
+    }
+    countSpan.end();
+
+    profiler::ScopedSpan prefixSpan("prefix sum");
+    for (size_t i = 1; i < count.size(); i++) {
+        count[i] += count[i - 1];
+        publishCount(i);
+        callback(arr, -1, -1, setExplanation(text, "Calculating cumulative count for value ", i,
+                                             "\nComparisons: ", stats.comparisons));
+    }
+    prefixSpan.end();
+
+    profiler::ScopedSpan scatterSpan("scatter pass");
+    for (int i = arr.size() - 1; i >= 0; i--) {
+        output[count[arr[i]] - 1] = arr[i];
+        count[arr[i]]--;
+        stats.swaps++;
+        publishCount(arr[i]);
+        callback(arr, i, -1, setExplanation(text, "Placing ", arr[i], " in output array\nOperations: ",
+                                            stats.swaps));
+    }
+    scatterSpan.end();
+
+    profiler::ScopedSpan copySpan("copy back");
+    for (size_t i = 0; i < arr.size(); i++) {
+        arr[i] = output[i];
+        callback(arr, i, -1, setExplanation(text, "Updating main array with sorted elements\nOperations: ",
+                                            stats.swaps));
+    }
+    copySpan.end();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, -1, -1, "Counting Sort Complete!\nTime: " + 
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Operations: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+namespace {
+
+// Order-preserving map from float bits to unsigned keys: flip every bit of
+// negatives, only the sign bit of positives. NaNs get the sign bit forced on
+// so they sort above +infinity regardless of their own sign.
+template <typename Bits>
+Bits orderedFloatKey(Bits u) {
+    constexpr int bits = sizeof(Bits) * 8;
+    constexpr Bits signBit = Bits(1) << (bits - 1);
+    constexpr Bits expMask = sizeof(Bits) == 4 ? Bits(0x7F800000u) : Bits(0x7FF0000000000000ull);
+    constexpr Bits mantMask = sizeof(Bits) == 4 ? Bits(0x007FFFFFu) : Bits(0x000FFFFFFFFFFFFFull);
+
+    if ((u & expMask) == expMask && (u & mantMask) != 0) return u | signBit;
+    return (u & signBit) ? ~u : (u | signBit);
+}
+
+template <typename Float, typename Bits>
+void floatingRadixSortImpl(std::vector<Float>& arr,
+                           const std::function<void(const std::vector<Float>&, int, int, const std::string&)>& callback,
+                           const std::string& name) {
+    static_assert(sizeof(Float) == sizeof(Bits), "key width must match the float width");
+    constexpr int passes = sizeof(Bits);
+
+    SortStats stats;
+    stats.timeComplexity = "O(n * " + std::to_string(passes) + ")";
+    stats.spaceComplexity = "O(n + 256)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    size_t n = arr.size();
+    if (n == 0) return;
+
+    // One read pass builds the histogram for every digit
+    profiler::ScopedSpan countSpan("count pass");
+    std::vector<size_t> count(passes * 256, 0);
+    for (size_t i = 0; i < n; i++) {
+        Bits u;
+        std::memcpy(&u, &arr[i], sizeof(Bits));
+        Bits key = orderedFloatKey(u);
+        for (int p = 0; p < passes; p++) {
+            count[p * 256 + ((key >> (8 * p)) & 0xFF)]++;
+        }
+    }
+
+    countSpan.end();
+
+    std::vector<Float> buffer(n);
+    for (int p = 0; p < passes; p++) {
+        size_t* digitCount = &count[p * 256];
+
+        // A digit shared by every key cannot reorder anything
+        if (std::find(digitCount, digitCount + 256, n) != digitCount + 256) {
+            callback(arr, -1, -1, "Skipping byte " + std::to_string(p) +
+                                  " (identical for all keys)\nOperations: " +
+                                  std::to_string(stats.swaps));
+            continue;
+        }
+
+        profiler::ScopedSpan scatterSpan("scatter pass");
+        size_t offset = 0;
+        for (int d = 0; d < 256; d++) {
+            size_t c = digitCount[d];
+            digitCount[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            Bits u;
+            std::memcpy(&u, &arr[i], sizeof(Bits));
+            buffer[digitCount[(orderedFloatKey(u) >> (8 * p)) & 0xFF]++] = arr[i];
+            stats.swaps++;
+        }
+        // Ping-pong by swapping storage instead of copying back
+        arr.swap(buffer);
+        scatterSpan.end();
+        callback(arr, -1, -1, "Scattered by byte " + std::to_string(p) +
+                              "\nOperations: " + std::to_string(stats.swaps));
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, -1, -1, name + " Complete!\nTime: " +
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Operations: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+} // namespace
+
+void floatRadixSort(std::vector<float>& arr,
+                   std::function<void(const std::vector<float>&, int, int, const std::string&)> callback) {
+    floatingRadixSortImpl<float, uint32_t>(arr, callback, "Float Radix Sort");
+}
+
+void doubleRadixSort(std::vector<double>& arr,
+                    std::function<void(const std::vector<double>&, int, int, const std::string&)> callback) {
+    floatingRadixSortImpl<double, uint64_t>(arr, callback, "Double Radix Sort");
+}
+
+void StringArena::assign(const std::vector<std::string>& strings) {
+    chars.clear();
+    offsets.clear();
+    lengths.clear();
+    prefixes.clear();
+
+    size_t total = 0;
+    for (const auto& s : strings) total += s.size();
+    chars.reserve(total);
+    offsets.reserve(strings.size());
+    lengths.reserve(strings.size());
+    prefixes.reserve(strings.size());
+
+    for (const auto& s : strings) {
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+        lengths.push_back(static_cast<uint32_t>(s.size()));
+        chars.insert(chars.end(), s.begin(), s.end());
+    }
+    for (uint32_t id = 0; id < offsets.size(); ++id) {
+        prefixes.push_back(wordAt(id, 0));
+    }
+}
+
+std::string StringArena::str(uint32_t id) const {
+    return std::string(chars.data() + offsets[id], lengths[id]);
+}
+
+int StringArena::charAt(uint32_t id, int depth) const {
+    if (depth >= static_cast<int>(lengths[id])) return -1;
+    if (depth < 8 && id < prefixes.size()) {
+        return static_cast<int>((prefixes[id] >> (56 - 8 * depth)) & 0xFF);
+    }
+    return static_cast<unsigned char>(chars[offsets[id] + depth]);
+}
+
+uint64_t StringArena::wordAt(uint32_t id, int depth) const {
+    if (depth == 0 && id < prefixes.size()) return prefixes[id];
+
+    uint64_t word = 0;
+    int len = static_cast<int>(lengths[id]);
+    const char* p = chars.data() + offsets[id];
+    for (int k = 0; k < 8; ++k) {
+        word <<= 8;
+        if (depth + k < len) word |= static_cast<unsigned char>(p[depth + k]);
+    }
+    return word;
+}
+
+int StringArena::compareFrom(uint32_t a, uint32_t b, int depth) const {
+    int lenA = static_cast<int>(lengths[a]);
+    int lenB = static_cast<int>(lengths[b]);
+
+    // Compare a word at a time while both strings still have 8 bytes left
+    while (depth + 8 <= lenA && depth + 8 <= lenB) {
+        uint64_t wa = wordAt(a, depth);
+        uint64_t wb = wordAt(b, depth);
+        if (wa != wb) return wa < wb ? -1 : 1;
+        depth += 8;
+    }
+    for (;; ++depth) {
+        int ca = charAt(a, depth);
+        int cb = charAt(b, depth);
+        if (ca != cb) return ca < cb ? -1 : 1;
+        if (ca == -1) return 0;
+    }
+}
+
+namespace {
+
+using StringCallback = std::function<void(const std::vector<std::string>&, int, int, const std::string&)>;
+
+// Advances depth past bytes shared by every string in order[lo, hi), eight
+// bytes at a time, so neither engine re-examines a common prefix.
+int skipCommonPrefix(const StringArena& arena, const std::vector<uint32_t>& order,
+                     int lo, int hi, int depth, SortStats& stats) {
+    for (;;) {
+        uint32_t first = order[lo];
+        if (static_cast<int>(arena.lengths[first]) < depth + 8) return depth;
+        uint64_t word = arena.wordAt(first, depth);
+        for (int i = lo + 1; i < hi; ++i) {
+            stats.comparisons++;
+            if (static_cast<int>(arena.lengths[order[i]]) < depth + 8 ||
+                arena.wordAt(order[i], depth) != word) {
+                return depth;
+            }
+        }
+        depth += 8;
+    }
+}
+
+struct StringSortContext {
+    const StringArena& arena;
+    std::vector<uint32_t>& order;
+    SortStats& stats;
+    VisualizerState& state;
+    const StringCallback& callback;
+    std::vector<std::string> view;
+
+    void emit(int i, int j, int depth, const std::string& explanation) {
+        view.resize(order.size());
+        for (size_t k = 0; k < order.size(); ++k) view[k] = arena.str(order[k]);
+        state.currentDigit = depth;
+        callback(view, i, j, explanation + "\nDepth: " + std::to_string(depth) +
+                             "\nComparisons: " + std::to_string(stats.comparisons) +
+                             "\nOperations: " + std::to_string(stats.swaps));
+    }
+};
+
+std::string describeChar(int c) {
+    if (c < 0) return "<end>";
+    return std::string("'") + static_cast<char>(c) + "'";
+}
+
+void multikeyRecurse(StringSortContext& ctx, int lo, int hi, int depth) {
+    if (hi - lo <= 1) return;
+
+    depth = skipCommonPrefix(ctx.arena, ctx.order, lo, hi, depth, ctx.stats);
+    int pivot = ctx.arena.charAt(ctx.order[lo + (hi - lo) / 2], depth);
+    ctx.emit(lo, hi - 1, depth, "Pivot character " + describeChar(pivot) +
+                                " for range " + std::to_string(lo) + "-" + std::to_string(hi - 1));
+
+    int lt = lo, gt = hi, i = lo;
+    while (i < gt) {
+        int c = ctx.arena.charAt(ctx.order[i], depth);
+        ctx.stats.comparisons++;
+        if (c < pivot) {
+            std::swap(ctx.order[lt++], ctx.order[i++]);
+            ctx.stats.swaps++;
+        } else if (c > pivot) {
+            std::swap(ctx.order[i], ctx.order[--gt]);
+            ctx.stats.swaps++;
+        } else {
+            i++;
+        }
+    }
+    ctx.emit(lt, gt - 1, depth, "Three-way split on " + describeChar(pivot) + ": less (" +
+                                std::to_string(lo) + "-" + std::to_string(lt - 1) + "), equal (" +
+                                std::to_string(lt) + "-" + std::to_string(gt - 1) + "), greater (" +
+                                std::to_string(gt) + "-" + std::to_string(hi - 1) + ")");
+
+    multikeyRecurse(ctx, lo, lt, depth);
+    if (pivot >= 0) multikeyRecurse(ctx, lt, gt, depth + 1);
+    multikeyRecurse(ctx, gt, hi, depth);
+}
+
+void msdRadixRecurse(StringSortContext& ctx, std::vector<uint32_t>& scratch,
+                     int lo, int hi, int depth, int cutoff) {
+    if (hi - lo <= 1) return;
+
+    if (hi - lo < cutoff) {
+        for (int i = lo + 1; i < hi; ++i) {
+            uint32_t key = ctx.order[i];
+            int j = i - 1;
+            while (j >= lo) {
+                ctx.stats.comparisons++;
+                if (ctx.arena.compareFrom(ctx.order[j], key, depth) <= 0) break;
+                ctx.order[j + 1] = ctx.order[j];
+                ctx.stats.swaps++;
+                j--;
+            }
+            ctx.order[j + 1] = key;
+        }
+        ctx.emit(lo, hi - 1, depth, "Insertion sorted small range " +
+                                    std::to_string(lo) + "-" + std::to_string(hi - 1));
+        return;
+    }
+
+    depth = skipCommonPrefix(ctx.arena, ctx.order, lo, hi, depth, ctx.stats);
+
+    // Bucket 0 holds strings that end at this depth
+    int count[258] = {0};
+    for (int i = lo; i < hi; ++i) {
+        count[ctx.arena.charAt(ctx.order[i], depth) + 2]++;
+        ctx.stats.comparisons++;
+    }
+    for (int b = 1; b < 258; ++b) count[b] += count[b - 1];
+
+    for (int i = lo; i < hi; ++i) {
+        uint32_t id = ctx.order[i];
+        scratch[lo + count[ctx.arena.charAt(id, depth) + 1]++] = id;
+        ctx.stats.swaps++;
+    }
+    std::copy(scratch.begin() + lo, scratch.begin() + hi, ctx.order.begin() + lo);
+    ctx.emit(lo, hi - 1, depth, "Distributed range " + std::to_string(lo) + "-" +
+                                std::to_string(hi - 1) + " by character");
+
+    // After scattering, bucket b spans [count[b - 1], count[b]); bucket 0
+    // (strings that ended) is already in final order
+    for (int b = 1; b < 257; ++b) {
+        msdRadixRecurse(ctx, scratch, lo + count[b - 1], lo + count[b], depth + 1, cutoff);
+    }
+}
+
+} // namespace
+
+void multikeyQuickSort(std::vector<std::string>& arr,
+                      std::function<void(const std::vector<std::string>&, int, int, const std::string&)> callback,
+                      VisualizerState& state) {
+    if (arr.empty()) return;
+
+    SortStats stats;
+    stats.timeComplexity = "O(n log n + D)";
+    stats.spaceComplexity = "O(log n)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    StringArena arena;
+    arena.assign(arr);
+    std::vector<uint32_t> order(arr.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    StringSortContext ctx{arena, order, stats, state, callback, {}};
+    multikeyRecurse(ctx, 0, static_cast<int>(order.size()), 0);
+
+    for (size_t i = 0; i < order.size(); ++i) arr[i] = arena.str(order[i]);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    state.currentDigit = -1;
+    callback(arr, -1, -1, "Multikey QuickSort Complete!\nTime: " +
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Operations: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+void msdRadixSort(std::vector<std::string>& arr,
+                 std::function<void(const std::vector<std::string>&, int, int, const std::string&)> callback,
+                 VisualizerState& state,
+                 int insertionCutoff) {
+    if (arr.empty()) return;
+
+    SortStats stats;
+    stats.timeComplexity = "O(n + D)";
+    stats.spaceComplexity = "O(n + 256)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    StringArena arena;
+    arena.assign(arr);
+    std::vector<uint32_t> order(arr.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::vector<uint32_t> scratch(arr.size());
+
+    StringSortContext ctx{arena, order, stats, state, callback, {}};
+    msdRadixRecurse(ctx, scratch, 0, static_cast<int>(order.size()), 0, insertionCutoff);
+
+    for (size_t i = 0; i < order.size(); ++i) arr[i] = arena.str(order[i]);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    state.currentDigit = -1;
+    callback(arr, -1, -1, "MSD Radix Sort Complete!\nTime: " +
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Operations: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+
+namespace {
+
+struct MergeRun {
+    int base;
+    int len;
+};
+
+enum class RunEvent {
+    RunFound,
+    RunReversed,
+    RunExtended,
+    MergeStart,
+    MergeStep,
+    GallopStart,
+    GallopCopy,
+    GallopEnd,
+    MergeDone
+};
+
+struct NullRunObserver {
+    void operator()(RunEvent, int, int, const std::vector<MergeRun>&) {}
+};
+
+// Timsort over ints: natural runs (descending ones reversed), short runs
+// extended to minRun with binary insertion, merges kept balanced by the
+// run-stack invariants, and galloping once one side keeps winning.
+template <typename Observer>
+class TimSorter {
+public:
+    TimSorter(std::vector<int>& a, const TimSortParams& params, Observer& observer)
+        : a(a), observer(observer), initialMinGallop(std::max(1, params.minGallop)),
+          minGallop(initialMinGallop), minRunOverride(params.minRun) {}
+
+    void sort() {
+        int n = static_cast<int>(a.size());
+        if (n < 2) return;
+
+        int minRun = minRunOverride > 0 ? minRunOverride : minRunLength(n);
+        int lo = 0;
+        while (lo < n) {
+            int runLen = countRunAndMakeAscending(lo, n);
+            if (runLen < minRun) {
+                int force = std::min(minRun, n - lo);
+                binaryInsertion(lo, lo + force, lo + runLen);
+                runLen = force;
+                observer(RunEvent::RunExtended, lo, lo + runLen - 1, runs);
+            }
+            runs.push_back({lo, runLen});
+            mergeCollapse();
+            lo += runLen;
+        }
+        while (runs.size() > 1) {
+            int i = static_cast<int>(runs.size()) - 2;
+            if (i > 0 && runs[i - 1].len < runs[i + 1].len) i--;
+            mergeAt(i);
+        }
+    }
+
+    long long comparisons = 0;
+    long long moves = 0;
+    std::vector<MergeRun> runs;
+
+private:
+    static int minRunLength(int n) {
+        int r = 0;
+        while (n >= 64) {
+            r |= n & 1;
+            n >>= 1;
+        }
+        return n + r;
+    }
+
+    bool less(int x, int y) {
+        comparisons++;
+        return x < y;
+    }
+
+    int countRunAndMakeAscending(int lo, int hi) {
+        int runHi = lo + 1;
+        if (runHi == hi) {
+            observer(RunEvent::RunFound, lo, lo, runs);
+            return 1;
+        }
+        if (less(a[runHi++], a[lo])) {
+            // Strictly descending, so reversing keeps the sort stable
+            while (runHi < hi && less(a[runHi], a[runHi - 1])) runHi++;
+            std::reverse(a.begin() + lo, a.begin() + runHi);
+            moves += runHi - lo;
+            observer(RunEvent::RunReversed, lo, runHi - 1, runs);
+        } else {
+            while (runHi < hi && !less(a[runHi], a[runHi - 1])) runHi++;
+            observer(RunEvent::RunFound, lo, runHi - 1, runs);
+        }
+        return runHi - lo;
+    }
+
+    // Elements [lo, start) are already sorted
+    void binaryInsertion(int lo, int hi, int start) {
+        for (; start < hi; start++) {
+            int pivot = a[start];
+            int left = lo, right = start;
+            while (left < right) {
+                int mid = (left + right) >> 1;
+                if (less(pivot, a[mid])) right = mid;
+                else left = mid + 1;
+            }
+            std::move_backward(a.begin() + left, a.begin() + start, a.begin() + start + 1);
+            a[left] = pivot;
+            moves += start - left + 1;
+        }
+    }
+
+    // Number of leading elements of p[0, len) that satisfy pred, found by
+    // exponential search from one end followed by a binary search
+    template <typename Pred>
+    int gallop(const int* p, int len, bool fromEnd, Pred pred) {
+        auto counted = [&](int v) {
+            comparisons++;
+            return pred(v);
+        };
+        int lo = 0, hi = len;
+        if (!fromEnd) {
+            int step = 1;
+            while (lo + step <= len && counted(p[lo + step - 1])) {
+                lo += step;
+                step <<= 1;
+            }
+            hi = std::min(len, lo + step - 1);
+        } else {
+            int step = 1;
+            while (hi - step >= 0 && !counted(p[hi - step])) {
+                hi -= step;
+                step <<= 1;
+            }
+            lo = hi - step >= 0 ? hi - step + 1 : 0;
+        }
+        return static_cast<int>(std::partition_point(p + lo, p + hi, counted) - p);
+    }
+
+    // Count of p[0, len) that are <= key
+    int gallopRight(int key, const int* p, int len, bool fromEnd) {
+        return gallop(p, len, fromEnd, [key](int v) { return !(key < v); });
+    }
+
+    // Count of p[0, len) that are < key
+    int gallopLeft(int key, const int* p, int len, bool fromEnd) {
+        return gallop(p, len, fromEnd, [key](int v) { return v < key; });
+    }
+
+    void mergeCollapse() {
+        while (runs.size() > 1) {
+            int n = static_cast<int>(runs.size()) - 2;
+            if ((n > 0 && runs[n - 1].len <= runs[n].len + runs[n + 1].len) ||
+                (n > 1 && runs[n - 2].len <= runs[n - 1].len + runs[n].len)) {
+                if (runs[n - 1].len < runs[n + 1].len) n--;
+            } else if (runs[n].len > runs[n + 1].len) {
+                break;
+            }
+            mergeAt(n);
+        }
+    }
+
+    void mergeAt(int i) {
+        profiler::ScopedSpan span("merge");
+        int base1 = runs[i].base, len1 = runs[i].len;
+        int base2 = runs[i + 1].base, len2 = runs[i + 1].len;
+
+        runs[i].len = len1 + len2;
+        runs.erase(runs.begin() + i + 1);
+        observer(RunEvent::MergeStart, base1, base2 + len2 - 1, runs);
+
+        // Skip the prefix of run 1 and the suffix of run 2 already in place
+        int k = gallopRight(a[base2], a.data() + base1, len1, false);
+        base1 += k;
+        len1 -= k;
+        if (len1 > 0) {
+            len2 = gallopLeft(a[base1 + len1 - 1], a.data() + base2, len2, true);
+            if (len2 > 0) {
+                if (len1 <= len2) mergeLo(base1, len1, base2, len2);
+                else mergeHi(base1, len1, base2, len2);
+            }
+        }
+        observer(RunEvent::MergeDone, runs[i].base, runs[i].base + runs[i].len - 1, runs);
+    }
+
+    void mergeLo(int base1, int len1, int base2, int len2) {
+        tmp.assign(a.begin() + base1, a.begin() + base1 + len1);
+        int i = 0, j = base2, d = base1;
+        const int end2 = base2 + len2;
+
+        while (i < len1 && j < end2) {
+            int count1 = 0, count2 = 0;
+            while (i < len1 && j < end2) {
+                if (less(a[j], tmp[i])) {
+                    a[d++] = a[j++];
+                    count2++;
+                    count1 = 0;
+                } else {
+                    a[d++] = tmp[i++];
+                    count1++;
+                    count2 = 0;
+                }
+                moves++;
+                observer(RunEvent::MergeStep, d - 1, j < end2 ? j : -1, runs);
+                if (count1 >= minGallop || count2 >= minGallop) break;
+            }
+            if (i >= len1 || j >= end2) break;
+
+            observer(RunEvent::GallopStart, d, j, runs);
+            do {
+                count1 = gallopRight(a[j], tmp.data() + i, len1 - i, false);
+                std::copy(tmp.begin() + i, tmp.begin() + i + count1, a.begin() + d);
+                i += count1;
+                d += count1;
+                moves += count1;
+                if (i >= len1) break;
+
+                count2 = gallopLeft(tmp[i], a.data() + j, end2 - j, false);
+                std::copy(a.begin() + j, a.begin() + j + count2, a.begin() + d);
+                j += count2;
+                d += count2;
+                moves += count2;
+                observer(RunEvent::GallopCopy, d - 1, count1 + count2, runs);
+                if (j >= end2) break;
+
+                a[d++] = tmp[i++];
+                moves++;
+                if (i >= len1) break;
+                minGallop--;
+            } while (count1 >= initialMinGallop || count2 >= initialMinGallop);
+            minGallop = std::max(minGallop, 0) + 2;
+            observer(RunEvent::GallopEnd, d, j < end2 ? j : -1, runs);
+        }
+        std::copy(tmp.begin() + i, tmp.begin() + len1, a.begin() + d);
+        moves += len1 - i;
+        minGallop = std::max(minGallop, 1);
+    }
+
+    // Mirror of mergeLo, filling from the right when run 2 is shorter
+    void mergeHi(int base1, int len1, int base2, int len2) {
+        tmp.assign(a.begin() + base2, a.begin() + base2 + len2);
+        int i = base1 + len1 - 1, j = len2 - 1, d = base2 + len2 - 1;
+
+        while (i >= base1 && j >= 0) {
+            int count1 = 0, count2 = 0;
+            while (i >= base1 && j >= 0) {
+                if (less(tmp[j], a[i])) {
+                    a[d--] = a[i--];
+                    count1++;
+                    count2 = 0;
+                } else {
+                    a[d--] = tmp[j--];
+                    count2++;
+                    count1 = 0;
+                }
+                moves++;
+                observer(RunEvent::MergeStep, d + 1, i >= base1 ? i : -1, runs);
+                if (count1 >= minGallop || count2 >= minGallop) break;
+            }
+            if (i < base1 || j < 0) break;
+
+            observer(RunEvent::GallopStart, d, i, runs);
+            do {
+                // Elements of run 1 greater than tmp[j] go after it
+                int left1 = i + 1 - base1;
+                count1 = left1 - gallopRight(tmp[j], a.data() + base1, left1, true);
+                std::copy_backward(a.begin() + i + 1 - count1, a.begin() + i + 1, a.begin() + d + 1);
+                i -= count1;
+                d -= count1;
+                moves += count1;
+                if (i < base1) break;
+
+                // Elements of run 2 not less than a[i] go after it
+                count2 = (j + 1) - gallopLeft(a[i], tmp.data(), j + 1, true);
+                std::copy_backward(tmp.begin() + j + 1 - count2, tmp.begin() + j + 1, a.begin() + d + 1);
+                j -= count2;
+                d -= count2;
+                moves += count2;
+                observer(RunEvent::GallopCopy, d + 1, count1 + count2, runs);
+                if (j < 0) break;
+
+                a[d--] = a[i--];
+                moves++;
+                if (i < base1) break;
+                minGallop--;
+            } while (count1 >= initialMinGallop || count2 >= initialMinGallop);
+            minGallop = std::max(minGallop, 0) + 2;
+            observer(RunEvent::GallopEnd, d, i >= base1 ? i : -1, runs);
+        }
+        std::copy(tmp.begin(), tmp.begin() + j + 1, a.begin() + base1);
+        moves += j + 1;
+        minGallop = std::max(minGallop, 1);
+    }
+
+    std::vector<int>& a;
+    Observer& observer;
+    std::vector<int> tmp;
+    const int initialMinGallop;
+    int minGallop;
+    int minRunOverride;
+};
+
+} // namespace
+
+void naturalMergeSort(std::vector<int>& arr, const TimSortParams& params) {
+    NullRunObserver observer;
+    TimSorter<NullRunObserver> sorter(arr, params, observer);
+    sorter.sort();
+}
+
+void naturalMergeSort(std::vector<int>& arr,
+                     std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+                     VisualizerState& state,
+                     const TimSortParams& params) {
+    SortStats stats;
+    stats.timeComplexity = "O(n log r), O(n) when presorted";
+    stats.spaceComplexity = "O(n)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    using Observer = std::function<void(RunEvent, int, int, const std::vector<MergeRun>&)>;
+    TimSorter<Observer>* sorter = nullptr;
+    std::string text;
+    Observer observer = [&](RunEvent event, int i, int j, const std::vector<MergeRun>& runs) {
+            state.runBoundaries.clear();
+            for (const MergeRun& run : runs) state.runBoundaries.push_back(run.base);
+            if (event == RunEvent::RunFound || event == RunEvent::RunReversed ||
+                event == RunEvent::RunExtended) {
+                // The run being formed is not on the stack yet
+                state.runBoundaries.push_back(i);
+                state.runBoundaries.push_back(j + 1);
+            }
+
+            switch (event) {
+                case RunEvent::RunFound:
+                    setExplanation(text, "Found ascending run ", i, "-", j);
+                    break;
+                case RunEvent::RunReversed:
+                    setExplanation(text, "Reversed descending run ", i, "-", j);
+                    break;
+                case RunEvent::RunExtended:
+                    setExplanation(text, "Extended run ", i, "-", j, " to minimum length with binary insertion");
+                    break;
+                case RunEvent::MergeStart:
+                    setExplanation(text, "Merging runs covering ", i, "-", j, " (stack depth ", runs.size(), ")");
+                    break;
+                case RunEvent::MergeStep:
+                    setExplanation(text, "Merging: placed ", arr[i], " at index ", i);
+                    break;
+                case RunEvent::GallopStart:
+                    state.galloping = true;
+                    setExplanation(text, "One run keeps winning: entering galloping mode");
+                    break;
+                case RunEvent::GallopCopy:
+                    setExplanation(text, "Galloped: copied ", j, " elements in bulk");
+                    j = -1;
+                    break;
+                case RunEvent::GallopEnd:
+                    state.galloping = false;
+                    setExplanation(text, "Leaving galloping mode");
+                    break;
+                case RunEvent::MergeDone:
+                    setExplanation(text, "Merged run ", i, "-", j);
+                    break;
+            }
+            text += "\nComparisons: ";
+            appendPart(text, sorter->comparisons);
+            text += "\nMoves: ";
+            appendPart(text, sorter->moves);
+            callback(arr, i, j, text);
+        };
+
+    TimSorter<Observer> timSorter(arr, params, observer);
+    sorter = &timSorter;
+    timSorter.sort();
+    stats.comparisons = static_cast<int>(timSorter.comparisons);
+    stats.swaps = static_cast<int>(timSorter.moves);
+
+    state.runBoundaries.clear();
+    state.galloping = false;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, -1, -1, "Natural Merge Sort Complete!\nTime: " +
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Moves: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+InputProfile analyzeInput(const std::vector<int>& arr) {
+    InputProfile profile;
+    profile.n = arr.size();
+    if (arr.empty()) return profile;
+
+    const int* p = arr.data();
+    size_t n = arr.size();
+    int minValue = p[0];
+    int maxValue = p[0];
+    size_t descents = 0; // p[i] > p[i + 1]
+    size_t ascents = 0;  // p[i] < p[i + 1]
+    size_t i = 0;
+
+#ifdef SORT_ANALYZER_SSE2
+    // Compare four neighbouring pairs per iteration. Lane counters are
+    // flushed periodically so they cannot overflow on huge inputs.
+    __m128i vmin = _mm_set1_epi32(minValue);
+    __m128i vmax = _mm_set1_epi32(maxValue);
+    while (i + 4 < n) {
+        __m128i descAcc = _mm_setzero_si128();
+        __m128i ascAcc = _mm_setzero_si128();
+        size_t blockEnd = std::min(n - 4, i + (size_t(1) << 30));
+        for (; i < blockEnd; i += 4) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 1));
+            descAcc = _mm_sub_epi32(descAcc, _mm_cmpgt_epi32(a, b));
+            ascAcc = _mm_sub_epi32(ascAcc, _mm_cmplt_epi32(a, b));
+
+            __m128i lt = _mm_cmplt_epi32(a, vmin);
+            vmin = _mm_or_si128(_mm_and_si128(lt, a), _mm_andnot_si128(lt, vmin));
+            __m128i gt = _mm_cmpgt_epi32(a, vmax);
+            vmax = _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, vmax));
+        }
+        alignas(16) int32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), descAcc);
+        for (int32_t c : lanes) descents += static_cast<uint32_t>(c);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), ascAcc);
+        for (int32_t c : lanes) ascents += static_cast<uint32_t>(c);
+    }
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), vmin);
+    for (int32_t v : lanes) minValue = std::min(minValue, static_cast<int>(v));
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), vmax);
+    for (int32_t v : lanes) maxValue = std::max(maxValue, static_cast<int>(v));
+#endif
+
+    for (; i + 1 < n; i++) {
+        descents += p[i] > p[i + 1];
+        ascents += p[i] < p[i + 1];
+        minValue = std::min(minValue, p[i]);
+        maxValue = std::max(maxValue, p[i]);
+    }
+    minValue = std::min(minValue, p[n - 1]);
+    maxValue = std::max(maxValue, p[n - 1]);
+
+    profile.minValue = minValue;
+    profile.maxValue = maxValue;
+    profile.range = static_cast<long long>(maxValue) - minValue + 1;
+    profile.ascendingRuns = descents + 1;
+    profile.descendingRuns = ascents + 1;
+
+    // Duplicates: sort an evenly strided sample and count equal neighbours
+    const size_t sampleSize = std::min<size_t>(n, 1024);
+    std::vector<int> sample(sampleSize);
+    for (size_t k = 0; k < sampleSize; k++) sample[k] = p[k * n / sampleSize];
+    std::sort(sample.begin(), sample.end());
+    size_t equalNeighbours = 0;
+    for (size_t k = 1; k < sampleSize; k++) equalNeighbours += sample[k] == sample[k - 1];
+    profile.duplicateRatio = sampleSize > 1 ? double(equalNeighbours) / (sampleSize - 1) : 0.0;
+
+    // Inversions: fraction of random pairs out of order, scaled to all pairs.
+    // Every descent is an inversion, so that is a floor for the estimate.
+    double totalPairs = 0.5 * double(n) * double(n - 1);
+    if (n > 1) {
+        std::mt19937 gen(12345);
+        std::uniform_int_distribution<size_t> dist(0, n - 1);
+        const int pairSamples = 1024;
+        int inverted = 0;
+        for (int k = 0; k < pairSamples; k++) {
+            size_t a = dist(gen), b = dist(gen);
+            if (a > b) std::swap(a, b);
+            inverted += a != b && p[a] > p[b];
+        }
+        profile.estimatedInversions = std::max(double(descents), totalPairs * inverted / pairSamples);
+    }
+    return profile;
+}
+
+SortChoice chooseAlgorithm(const InputProfile& profile) {
+    const double n = static_cast<double>(profile.n);
+
+    if (profile.n <= 32) {
+        return SortChoice::Insertion;
+    }
+    // A few long runs in either direction are cheap to merge
+    if (std::min(profile.ascendingRuns, profile.descendingRuns) <= profile.n / 32) {
+        return SortChoice::NaturalMerge;
+    }
+    // Nearly sorted: insertion sort does O(n + inversions) work
+    if (profile.estimatedInversions <= n) {
+        return SortChoice::Insertion;
+    }
+    // Dense key range: one counting pass plus a table no bigger than 2n
+    if (profile.range <= 2 * static_cast<long long>(profile.n)) {
+        return SortChoice::Counting;
+    }
+    // Four byte passes beat n log n comparisons once n is not tiny, and
+    // are as fast on repeated keys as on distinct ones
+    if (profile.n >= 256) {
+        return SortChoice::Radix;
+    }
+    // Below that, mostly repeated keys finish in a few fat partitions
+    if (profile.duplicateRatio >= 0.5) {
+        return SortChoice::ThreeWay;
+    }
+    return SortChoice::Introsort;
+}
+
+const char* sortChoiceName(SortChoice choice) {
+    switch (choice) {
+        case SortChoice::Insertion: return "Insertion Sort";
+        case SortChoice::Counting: return "Counting Sort";
+        case SortChoice::Radix: return "Radix Sort";
+        case SortChoice::NaturalMerge: return "Natural Merge Sort";
+        case SortChoice::Introsort: return "Introsort";
+        case SortChoice::ThreeWay: return "3-way QuickSort";
+    }
+    return "Unknown";
+}
+
+std::string describeProfile(const InputProfile& profile, SortChoice choice) {
+    std::ostringstream oss;
+    oss << "Input analysis: n = " << profile.n
+        << ", range = [" << profile.minValue << ", " << profile.maxValue << "]\n"
+        << "Ascending runs: " << profile.ascendingRuns
+        << ", descending runs: " << profile.descendingRuns << "\n"
+        << std::fixed << std::setprecision(1)
+        << "Duplicates: " << profile.duplicateRatio * 100.0 << "%"
+        << ", estimated inversions: " << std::setprecision(0) << profile.estimatedInversions << "\n"
+        << "Chosen: " << sortChoiceName(choice);
+    return oss.str();
+}
+
+namespace {
+
+void insertionKernel(std::vector<int>& arr) {
+    for (size_t i = 1; i < arr.size(); i++) {
+        int key = arr[i];
+        size_t j = i;
+        while (j > 0 && arr[j - 1] > key) {
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        arr[j] = key;
+    }
+}
+
+// Dijkstra's three-way partition around a median-of-three pivot. Keys equal
+// to the pivot are finished where they land, so k distinct keys cost about
+// n log k; the smaller side is taken first to keep the stack short.
+void threeWayKernel(std::vector<int>& arr) {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ranges.emplace_back(0, arr.size());
+    while (!ranges.empty()) {
+        auto [low, high] = ranges.back();
+        ranges.pop_back();
+        if (high - low <= 16) {
+            for (size_t i = low + 1; i < high; i++) {
+                int key = arr[i];
+                size_t j = i;
+                for (; j > low && arr[j - 1] > key; j--) arr[j] = arr[j - 1];
+                arr[j] = key;
+            }
+            continue;
+        }
+        int a = arr[low], b = arr[low + (high - low) / 2], c = arr[high - 1];
+        int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        size_t lt = low, i = low, gt = high;
+        while (i < gt) {
+            if (arr[i] < pivot) std::swap(arr[lt++], arr[i++]);
+            else if (arr[i] > pivot) std::swap(arr[i], arr[--gt]);
+            else i++;
+        }
+        if (lt - low < high - gt) {
+            ranges.emplace_back(gt, high);
+            ranges.emplace_back(low, lt);
+        } else {
+            ranges.emplace_back(low, lt);
+            ranges.emplace_back(gt, high);
+        }
+    }
+}
+
+inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(SORT_ANALYZER_SSE2)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#endif
+}
+
+inline void prefetchWrite(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 1);
+#elif defined(SORT_ANALYZER_SSE2)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#endif
+}
+
+// One 64-byte line of staged values per digit. A line is copied out when
+// its next slot would start a new cache line, so after the first (partial)
+// line every copy is one aligned line, written with streaming stores where
+// SSE2 is available: each destination page is touched once per 16 values
+// and the old contents are never read in.
+template <typename T, size_t Digits>
+class WriteCombiner {
+public:
+    void push(T* out, size_t* next, size_t digit, T value) {
+        T* line = lines[digit];
+        size_t staged = fill[digit];
+        line[staged++] = value;
+        T* start = out + next[digit];
+        if ((reinterpret_cast<uintptr_t>(start + staged) & 63) != 0) {
+            fill[digit] = static_cast<uint8_t>(staged);
+            return;
+        }
+#ifdef SORT_ANALYZER_SSE2
+        if (staged == kLine) {
+            const __m128i* from = reinterpret_cast<const __m128i*>(line);
+            __m128i* to = reinterpret_cast<__m128i*>(start);
+            _mm_stream_si128(to, _mm_load_si128(from));
+            _mm_stream_si128(to + 1, _mm_load_si128(from + 1));
+            _mm_stream_si128(to + 2, _mm_load_si128(from + 2));
+            _mm_stream_si128(to + 3, _mm_load_si128(from + 3));
+        } else {
+            std::memcpy(start, line, staged * sizeof(T));
+        }
+#else
+        std::memcpy(start, line, staged * sizeof(T));
+#endif
+        next[digit] += staged;
+        fill[digit] = 0;
+    }
+
+    void flush(T* out, size_t* next) {
+        for (size_t digit = 0; digit < Digits; digit++) {
+            std::memcpy(out + next[digit], lines[digit], fill[digit] * sizeof(T));
+            next[digit] += fill[digit];
+            fill[digit] = 0;
+        }
+#ifdef SORT_ANALYZER_SSE2
+        _mm_sfence();
+#endif
+    }
+
+private:
+    static constexpr size_t kLine = 64 / sizeof(T);
+    alignas(64) T lines[Digits][kLine];
+    uint8_t fill[Digits] = {};
+};
+
+// One stable scatter pass: out[next[digitOf(v)]++] = v for each v in
+// order. Direct writes prefetch the slot the value `distance` elements
+// ahead will go to; staged lines are streamed, so they skip that.
+template <typename T, typename DigitOf>
+void scatterPass(const T* in, size_t n, T* out, size_t* next, const DigitOf& digitOf,
+                 const ScatterTuning& tuning) {
+    if (tuning.writeCombining) {
+        // 16 KiB for ints: kept off the stack of whichever thread calls
+        static thread_local WriteCombiner<T, 256> stagingLines;
+        WriteCombiner<T, 256>& staging = stagingLines;
+        for (size_t i = 0; i < n; i++) staging.push(out, next, digitOf(in[i]), in[i]);
+        staging.flush(out, next);
+        return;
+    }
+
+    const size_t distance = tuning.prefetchDistance > 0 ? static_cast<size_t>(tuning.prefetchDistance) : 0;
+    const size_t prefetchEnd = n > distance ? n - distance : 0;
+    size_t i = 0;
+    if (distance) {
+        for (; i < prefetchEnd; i++) {
+            prefetchWrite(out + next[digitOf(in[i + distance])]);
+            out[next[digitOf(in[i])]++] = in[i];
+        }
+    }
+    for (; i < n; i++) out[next[digitOf(in[i])]++] = in[i];
+}
+
+} // namespace
+
+ScatterTuning scatterTuningFor(size_t n) {
+    ScatterTuning tuning;
+    if (n >= kLargeScatterElements) {
+        tuning.pages = sortmem::PageMode::Transparent;
+        tuning.prefetchDistance = 16;
+        tuning.writeCombining = true;
+    }
+    return tuning;
+}
+
+void radixSort(std::vector<int>& arr, const ScatterTuning& tuning) {
+    const size_t n = arr.size();
+    if (n < 2) return;
+    sortmem::advisePages(arr.data(), n * sizeof(int), tuning.pages);
+
+    // Flipping the sign bit makes signed order unsigned
+    size_t count[4][256] = {};
+    for (int v : arr) {
+        uint32_t key = static_cast<uint32_t>(v) ^ 0x80000000u;
+        for (int pass = 0; pass < 4; pass++) count[pass][(key >> (8 * pass)) & 0xFF]++;
+    }
+
+    sortmem::PageBuffer buffer(n * sizeof(int), tuning.pages);
+    int* from = arr.data();
+    int* to = buffer.as<int>();
+    for (int pass = 0; pass < 4; pass++) {
+        size_t* next = count[pass];
+        if (std::find(next, next + 256, n) != next + 256) continue;
+        size_t offset = 0;
+        for (int d = 0; d < 256; d++) {
+            size_t c = next[d];
+            next[d] = offset;
+            offset += c;
+        }
+        const int shift = 8 * pass;
+        scatterPass(from, n, to, next, [shift](int v) {
+            return ((static_cast<uint32_t>(v) ^ 0x80000000u) >> shift) & 0xFF;
+        }, tuning);
+        std::swap(from, to);
+    }
+    if (from != arr.data()) std::memcpy(arr.data(), from, n * sizeof(int));
+}
+
+void countingSort(std::vector<int>& arr, const ScatterTuning& tuning) {
+    if (arr.empty()) return;
+    auto [minIt, maxIt] = std::minmax_element(arr.begin(), arr.end());
+    const int minValue = *minIt;
+    const size_t range = static_cast<size_t>(static_cast<long long>(*maxIt) - minValue + 1);
+
+    // Random increments into the table are this kernel's scattered writes;
+    // writing the output back is sequential, so staging has nothing to do
+    sortmem::PageBuffer table(range * sizeof(size_t), tuning.pages);
+    size_t* count = table.as<size_t>();
+    std::memset(count, 0, range * sizeof(size_t));
+
+    const size_t n = arr.size();
+    const int* in = arr.data();
+    const size_t distance = tuning.prefetchDistance > 0 ? static_cast<size_t>(tuning.prefetchDistance) : 0;
+    size_t i = 0;
+    if (distance) {
+        for (; i + distance < n; i++) {
+            prefetchWrite(count + (in[i + distance] - minValue));
+            count[in[i] - minValue]++;
+        }
+    }
+    for (; i < n; i++) count[in[i] - minValue]++;
+
+    size_t out = 0;
+    for (size_t v = 0; v < range; v++) {
+        std::fill_n(arr.begin() + out, count[v], static_cast<int>(v + minValue));
+        out += count[v];
+    }
+}
+
+void bucketSort(std::vector<float>& arr, const ScatterTuning& tuning) {
+    const size_t n = arr.size();
+    if (n < 2) return;
+    sortmem::advisePages(arr.data(), n * sizeof(float), tuning.pages);
+
+    // Bucket floor(x * n) as in the visual bucketSort; NaN goes to bucket 0
+    auto bucketOf = [n](float x) {
+        double scaled = static_cast<double>(x) * static_cast<double>(n);
+        return scaled >= static_cast<double>(n) ? n - 1 : scaled > 0 ? static_cast<size_t>(scaled) : 0;
+    };
+
+    // Pass 1: 256 ranges of consecutive buckets, few enough to write-combine
+    int shift = 0;
+    while (((n - 1) >> shift) >= 256) shift++;
+    size_t rangeStart[257] = {};
+    for (float x : arr) rangeStart[(bucketOf(x) >> shift) + 1]++;
+    for (int r = 0; r < 256; r++) rangeStart[r + 1] += rangeStart[r];
+    size_t next[256];
+    std::copy(rangeStart, rangeStart + 256, next);
+
+    sortmem::PageBuffer buffer(n * sizeof(float), tuning.pages);
+    float* staged = buffer.as<float>();
+    scatterPass(arr.data(), n, staged, next, [&](float x) { return bucketOf(x) >> shift; }, tuning);
+
+    // Pass 2: each range into its 2^shift buckets, back in the array. A
+    // range is about 256th of the input, so this pass stays cache- and
+    // TLB-local; the buckets then hold one element on average.
+    const size_t perRange = size_t(1) << shift;
+    std::vector<size_t> bucketStart(perRange + 1);
+    std::vector<size_t> slot(perRange);
+    for (size_t r = 0; r < 256; r++) {
+        const size_t begin = rangeStart[r];
+        const size_t end = rangeStart[r + 1];
+        if (end - begin < 2) {
+            if (end > begin) arr[begin] = staged[begin];
+            continue;
+        }
+        const size_t firstBucket = r << shift;
+        std::fill(bucketStart.begin(), bucketStart.end(), 0);
+        for (size_t i = begin; i < end; i++) bucketStart[bucketOf(staged[i]) - firstBucket + 1]++;
+        bucketStart[0] = begin;
+        for (size_t b = 0; b < perRange; b++) bucketStart[b + 1] += bucketStart[b];
+        std::copy(bucketStart.begin(), bucketStart.end() - 1, slot.begin());
+        for (size_t i = begin; i < end; i++) arr[slot[bucketOf(staged[i]) - firstBucket]++] = staged[i];
+        for (size_t b = 0; b < perRange; b++) {
+            if (bucketStart[b + 1] - bucketStart[b] > 1) {
+                std::sort(arr.begin() + bucketStart[b], arr.begin() + bucketStart[b + 1]);
+            }
+        }
+    }
+}
+
+void runSortChoice(std::vector<int>& arr, SortChoice choice) {
+    switch (choice) {
+        case SortChoice::Insertion: insertionKernel(arr); break;
+        case SortChoice::Counting: countingSort(arr, scatterTuningFor(arr.size())); break;
+        case SortChoice::Radix: radixSort(arr, scatterTuningFor(arr.size())); break;
+        case SortChoice::NaturalMerge: naturalMergeSort(arr); break;
+        case SortChoice::Introsort: std::sort(arr.begin(), arr.end()); break;
+        case SortChoice::ThreeWay: threeWayKernel(arr); break;
+    }
+}
+
+void adaptiveSort(std::vector<int>& arr,
+                 const InputProfile& profile,
+                 SortChoice choice,
+                 std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+                 VisualizerState& state) {
+    std::string analysis = describeProfile(profile, choice);
+    callback(arr, -1, -1, analysis);
+
+    // Keep the decision visible while the chosen algorithm narrates its steps
+    std::string tag = std::string("[Adaptive: ") + sortChoiceName(choice) + "] ";
+    auto taggedCallback = [&](const std::vector<int>& a, int i, int j, const std::string& explanation) {
+        callback(a, i, j, tag + explanation);
+    };
+
+    // The visual counting and radix sorts only handle non-negative keys
+    bool visualKeys = profile.minValue >= 0;
+    if (choice == SortChoice::Insertion) {
+        insertionSort(arr, taggedCallback);
+    } else if (choice == SortChoice::Counting && visualKeys) {
+        countingSort(arr, taggedCallback, state);
+    } else if (choice == SortChoice::Radix && visualKeys) {
+        radixSort(arr, taggedCallback);
+    } else if (choice == SortChoice::NaturalMerge) {
+        naturalMergeSort(arr, taggedCallback, state);
+    } else {
+        // No step-by-step view for this choice; show the result directly
+        runSortChoice(arr, choice);
+        callback(arr, -1, -1, analysis + "\n" + sortChoiceName(choice) + " Complete!");
+    }
+}
+
+namespace {
+
+enum class SelectEvent {
+    Pivot,
+    Compare,
+    Swap,
+    Partitioned,
+    HeapFallback
+};
+
+struct NullSelectObserver {
+    void operator()(SelectEvent, int, int, int, int) {}
+};
+
+// Restores the max-heap property of h[0, size) below index i
+void siftDownMax(int* h, int size, int i, SortStats& stats) {
+    int value = h[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= size) break;
+        if (child + 1 < size && h[child] < h[child + 1]) child++;
+        stats.comparisons += 2;
+        if (!(value < h[child])) break;
+        h[i] = h[child];
+        stats.swaps++;
+        i = child;
+    }
+    h[i] = value;
+}
+
+void buildMaxHeap(int* h, int size, SortStats& stats) {
+    for (int i = size / 2 - 1; i >= 0; i--) siftDownMax(h, size, i, stats);
+}
+
+// lomutoPartition with the select's counters and observer events
+template <typename Observer>
+int observedPartition(std::vector<int>& arr, int low, int high, SortStats& stats, Observer& observer) {
+    profiler::ScopedSpan span("partition");
+    LomutoScan scan(arr, low, high);
+    while (!scan.done()) {
+        int j = scan.next;
+        stats.comparisons++;
+        observer(SelectEvent::Compare, j, high, low, high);
+        if (scan.step(arr)) {
+            stats.swaps++;
+            observer(SelectEvent::Swap, scan.last, j, low, high);
+        }
+    }
+    if (scan.finish(arr)) stats.swaps++;
+    return scan.pivotIndex();
+}
+
+// Keeps a max-heap of the k + 1 - low smallest values of arr[low, high]
+// and moves its maximum to index k
+void heapSelect(std::vector<int>& arr, int low, int high, int k, SortStats& stats) {
+    int* heap = arr.data() + low;
+    int size = k - low + 1;
+    buildMaxHeap(heap, size, stats);
+    for (int i = k + 1; i <= high; i++) {
+        stats.comparisons++;
+        if (arr[i] < heap[0]) {
+            std::swap(arr[i], heap[0]);
+            stats.swaps++;
+            siftDownMax(heap, size, 0, stats);
+        }
+    }
+    std::swap(heap[0], arr[k]);
+}
+
+template <typename Observer>
+void introselect(std::vector<int>& arr, int k, SortStats& stats, Observer& observer) {
+    int low = 0, high = static_cast<int>(arr.size()) - 1;
+    int depthLimit = 2 * static_cast<int>(std::log2(std::max<size_t>(arr.size(), 1)));
+
+    while (low < high) {
+        if (depthLimit-- == 0) {
+            heapSelect(arr, low, high, k, stats);
+            observer(SelectEvent::HeapFallback, k, -1, low, high);
+            return;
+        }
+
+        // Median of three parked at arr[high] keeps the last-element pivot
+        // away from the sorted-input worst case
+        int mid = low + (high - low) / 2;
+        if (arr[mid] < arr[low]) std::swap(arr[mid], arr[low]);
+        if (arr[high] < arr[low]) std::swap(arr[high], arr[low]);
+        if (arr[mid] < arr[high]) std::swap(arr[mid], arr[high]);
+        stats.comparisons += 3;
+        observer(SelectEvent::Pivot, high, -1, low, high);
+
+        int p = observedPartition(arr, low, high, stats, observer);
+        if (k == p) {
+            low = high = p;
+        } else if (k < p) {
+            high = p - 1;
+        } else {
+            low = p + 1;
+        }
+        observer(SelectEvent::Partitioned, p, -1, low, high);
+    }
+}
+
+int clampK(int k, size_t n) {
+    return std::max(0, std::min(k, static_cast<int>(n)));
+}
+
+} // namespace
+
+int quickSelect(std::vector<int>& arr, int k) {
+    if (arr.empty()) return 0;
+    k = std::max(0, std::min(k, static_cast<int>(arr.size()) - 1));
+    SortStats stats;
+    NullSelectObserver observer;
+    introselect(arr, k, stats, observer);
+    return arr[k];
+}
+
+std::vector<int> topK(const std::vector<int>& arr, int k) {
+    k = clampK(k, arr.size());
+    SortStats stats;
+    std::vector<int> heap;
+    heap.reserve(k);
+    if (k == 0) return heap;
+
+    for (int v : arr) {
+        if (static_cast<int>(heap.size()) < k) {
+            heap.push_back(v);
+            if (static_cast<int>(heap.size()) == k) buildMaxHeap(heap.data(), k, stats);
+        } else if (v < heap[0]) {
+            heap[0] = v;
+            siftDownMax(heap.data(), k, 0, stats);
+        }
+    }
+    std::sort(heap.begin(), heap.end());
+    return heap;
+}
+
+void partialSort(std::vector<int>& arr, int k) {
+    k = clampK(k, arr.size());
+    if (k == 0) return;
+    if (k < static_cast<int>(arr.size())) quickSelect(arr, k - 1);
+    std::sort(arr.begin(), arr.begin() + k);
+}
+
+void quickSelect(std::vector<int>& arr, int k,
+                std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+                VisualizerState& state) {
+    if (arr.empty()) return;
+    k = std::max(0, std::min(k, static_cast<int>(arr.size()) - 1));
+
+    SortStats stats;
+    stats.timeComplexity = "O(n) average, O(n log n) worst";
+    stats.spaceComplexity = "O(1)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::string text;
+    auto observer = [&](SelectEvent event, int i, int j, int low, int high) {
+        state.discarded.assign(arr.size(), false);
+        for (size_t idx = 0; idx < arr.size(); idx++) {
+            state.discarded[idx] = static_cast<int>(idx) < low || static_cast<int>(idx) > high;
+        }
+
+        switch (event) {
+            case SelectEvent::Pivot:
+                setExplanation(text, "Median-of-three pivot ", arr[i], " moved to index ", i);
+                break;
+            case SelectEvent::Compare:
+                setExplanation(text, "Comparing ", arr[i], " with pivot (", arr[j], ")");
+                break;
+            case SelectEvent::Swap:
+                setExplanation(text, "Swapped ", arr[i], " and ", arr[j]);
+                break;
+            case SelectEvent::Partitioned:
+                setExplanation(text, "Pivot settled at index ", i, "; searching ", low, "-", high,
+                               " for index ", k);
+                break;
+            case SelectEvent::HeapFallback:
+                setExplanation(text, "Recursion too deep: finished with heap selection");
+                break;
+        }
+        text += "\nComparisons: ";
+        appendPart(text, stats.comparisons);
+        text += "\nSwaps: ";
+        appendPart(text, stats.swaps);
+        callback(arr, i, j, text);
+    };
+    introselect(arr, k, stats, observer);
+
+    state.discarded.assign(arr.size(), true);
+    state.discarded[k] = false;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, k, -1, "QuickSelect Complete! Element " + std::to_string(k) + " is " +
+                        std::to_string(arr[k]) + "\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
+                        "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                        "Swaps: " + std::to_string(stats.swaps) + "\n" +
+                        "Time Complexity: " + stats.timeComplexity + "\n" +
+                        "Space Complexity: " + stats.spaceComplexity);
+}
+
+void topK(std::vector<int>& arr, int k,
+         std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+         VisualizerState& state) {
+    k = clampK(k, arr.size());
+    if (k == 0) return;
+
+    SortStats stats;
+    stats.timeComplexity = "O(n log k)";
+    stats.spaceComplexity = "O(k)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // arr[0, k) is the heap; arr[k, i] holds values the heap rejected
+    state.discarded.assign(arr.size(), false);
+    buildMaxHeap(arr.data(), k, stats);
+    callback(arr, 0, -1, "Built max-heap of the first " + std::to_string(k) + " elements (largest on top)\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons));
+
+    std::string text;
+    for (int i = k; i < static_cast<int>(arr.size()); i++) {
+        stats.comparisons++;
+        if (arr[i] < arr[0]) {
+            int incoming = arr[i];
+            std::swap(arr[i], arr[0]);
+            stats.swaps++;
+            siftDownMax(arr.data(), k, 0, stats);
+            state.discarded[i] = true;
+            callback(arr, 0, i, setExplanation(text, "Inserted ", incoming, " into the heap, evicted ", arr[i],
+                                               "\nComparisons: ", stats.comparisons, "\nSwaps: ", stats.swaps));
+        } else {
+            state.discarded[i] = true;
+            callback(arr, 0, i, setExplanation(text, "Discarded ", arr[i], " (not below heap top ", arr[0],
+                                               ")\nComparisons: ", stats.comparisons));
+        }
+    }
+
+    std::sort(arr.begin(), arr.begin() + k);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    callback(arr, -1, -1, "Top-" + std::to_string(k) + " Complete!\nTime: " +
+                         std::to_string(stats.timeTaken) + "ms\n" +
+                         "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                         "Swaps: " + std::to_string(stats.swaps) + "\n" +
+                         "Time Complexity: " + stats.timeComplexity + "\n" +
+                         "Space Complexity: " + stats.spaceComplexity);
+}
+
+void partialSort(std::vector<int>& arr, int k,
+                std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+                VisualizerState& state) {
+    k = clampK(k, arr.size());
+    if (k == 0) return;
+
+    if (k < static_cast<int>(arr.size())) {
+        quickSelect(arr, k - 1, callback, state);
+    }
+
+    // Only the k smallest still matter: insertion sort them in place
+    state.discarded.assign(arr.size(), false);
+    for (size_t i = k; i < arr.size(); i++) state.discarded[i] = true;
+    std::string text;
+    for (int i = 1; i < k; i++) {
+        int key = arr[i];
+        int j = i - 1;
+        while (j >= 0 && arr[j] > key) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+        callback(arr, j + 1, i, setExplanation(text, "Inserted ", key, " into the sorted prefix at ", j + 1));
+    }
+    callback(arr, -1, -1, "Partial Sort Complete! First " + std::to_string(k) + " elements are sorted");
+}
+
+
+namespace {
+
+// Super scalar sample sort (Sanders & Winkel). The k-1 splitters form an
+// implicit perfect binary search tree in tree[1, k); an element descends
+// it with j = 2j + (value > tree[j]), so classification has no branches
+// that depend on the data. Bucket b holds (splitter[b-1], splitter[b]].
+constexpr int kMaxLogBuckets = 8;              // 256 buckets; ids fit a byte
+constexpr size_t kSampleSortBaseCase = 4096;   // smaller ranges go to std::sort
+
+struct SplitterTree {
+    int logBuckets = 1;
+    int tree[1 << kMaxLogBuckets] = {};
+    bool equal[1 << kMaxLogBuckets] = {};  // bucket holds a single key, needs no sorting
+
+    size_t bucketCount() const { return size_t(1) << logBuckets; }
+
+    int bucketOf(int value) const {
+        size_t j = 1;
+        for (int level = 0; level < logBuckets; level++) j = 2 * j + (value > tree[j]);
+        return static_cast<int>(j - bucketCount());
+    }
+
+    // Four independent descents per iteration keep several loads in flight
+    void classify(const int* data, size_t n, uint8_t* oracle, size_t* counts) const {
+        const size_t k = bucketCount();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            size_t j0 = 1, j1 = 1, j2 = 1, j3 = 1;
+            for (int level = 0; level < logBuckets; level++) {
+                j0 = 2 * j0 + (data[i] > tree[j0]);
+                j1 = 2 * j1 + (data[i + 1] > tree[j1]);
+                j2 = 2 * j2 + (data[i + 2] > tree[j2]);
+                j3 = 2 * j3 + (data[i + 3] > tree[j3]);
+            }
+            oracle[i] = static_cast<uint8_t>(j0 - k);
+            oracle[i + 1] = static_cast<uint8_t>(j1 - k);
+            oracle[i + 2] = static_cast<uint8_t>(j2 - k);
+            oracle[i + 3] = static_cast<uint8_t>(j3 - k);
+            counts[j0 - k]++;
+            counts[j1 - k]++;
+            counts[j2 - k]++;
+            counts[j3 - k]++;
+        }
+        for (; i < n; i++) {
+            int b = bucketOf(data[i]);
+            oracle[i] = static_cast<uint8_t>(b);
+            counts[b]++;
+        }
+    }
+};
+
+void fillTree(SplitterTree& tree, const std::vector<int>& splitters, size_t node, size_t low, size_t high) {
+    if (low >= high) return;
+    size_t mid = low + (high - low) / 2;
+    tree.tree[node] = splitters[mid];
+    fillTree(tree, splitters, 2 * node, low, mid);
+    fillTree(tree, splitters, 2 * node + 1, mid + 1, high);
+}
+
+// A key that fills several sample slots comes out as a run of equal
+// splitters, and every copy of it would land in one bucket with the smaller
+// keys and be sorted again there. Lowering the run's first splitter to
+// key - 1 gives the key a bucket of its own, (key - 1, key], which is
+// marked equal; the rest of the run's buckets stay empty.
+void placeSplitters(SplitterTree& tree, std::vector<int>& splitters) {
+    for (size_t i = 0; i < splitters.size();) {
+        size_t end = i + 1;
+        while (end < splitters.size() && splitters[end] == splitters[i]) end++;
+        if (end - i > 1) {
+            if (splitters[i] > std::numeric_limits<int>::min()) {
+                splitters[i]--;
+                tree.equal[i + 1] = true;
+            } else {
+                tree.equal[i] = true;  // bucket 0 is (-inf, INT_MIN]
+            }
+        }
+        i = end;
+    }
+    fillTree(tree, splitters, 1, 0, splitters.size());
+}
+
+// Sorts an oversample of alpha * k random elements and keeps every
+// alpha-th one as a splitter
+SplitterTree chooseSplitters(const int* data, size_t n, int logBuckets, std::minstd_rand& rng) {
+    SplitterTree tree;
+    tree.logBuckets = logBuckets;
+    const size_t k = tree.bucketCount();
+    const size_t alpha = std::max<size_t>(4, static_cast<size_t>(std::log2(static_cast<double>(n))));
+
+    std::vector<int> sample(alpha * k);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    for (int& value : sample) value = data[pick(rng)];
+    std::sort(sample.begin(), sample.end());
+
+    std::vector<int> splitters(k - 1);
+    for (size_t i = 0; i + 1 < k; i++) splitters[i] = sample[(i + 1) * alpha - 1];
+    placeSplitters(tree, splitters);
+    return tree;
+}
+
+int sampleSortLogBuckets(size_t n) {
+    int logBuckets = 1;
+    while (logBuckets < kMaxLogBuckets && (n >> (logBuckets + 1)) >= kSampleSortBaseCase / 4) logBuckets++;
+    return logBuckets;
+}
+
+// Sequential recursion for one bucket; scratch has room for n elements
+void sampleSortRange(int* data, int* scratch, size_t n, std::minstd_rand& rng) {
+    if (n <= kSampleSortBaseCase) {
+        std::sort(data, data + n);
+        return;
+    }
+    SplitterTree tree = chooseSplitters(data, n, sampleSortLogBuckets(n), rng);
+    const size_t k = tree.bucketCount();
+    std::vector<uint8_t> oracle(n);
+    std::vector<size_t> counts(k + 1, 0);
+    tree.classify(data, n, oracle.data(), counts.data());
+
+    // Few distinct keys can put everything in one bucket; no progress left
+    auto full = std::find(counts.begin(), counts.end(), n);
+    if (full != counts.end()) {
+        if (!tree.equal[full - counts.begin()]) std::sort(data, data + n);
+        return;
+    }
+
+    std::vector<size_t> starts(k + 1, 0);
+    for (size_t b = 0; b < k; b++) starts[b + 1] = starts[b] + counts[b];
+    std::vector<size_t> next(starts.begin(), starts.end() - 1);
+    for (size_t i = 0; i < n; i++) scratch[next[oracle[i]]++] = data[i];
+    std::memcpy(data, scratch, n * sizeof(int));
+
+    for (size_t b = 0; b < k; b++) {
+        if (tree.equal[b]) continue;
+        sampleSortRange(data + starts[b], scratch + starts[b], starts[b + 1] - starts[b], rng);
+    }
+}
+
+// Runs fn(0..threads-1), fn(0) on the calling thread
+template<class Fn>
+void runOnThreads(unsigned threads, const Fn& fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; t++) workers.emplace_back(fn, t);
+    fn(0u);
+    for (std::thread& worker : workers) worker.join();
+}
+
+} // namespace
+
+void parallelSampleSort(std::vector<int>& arr, unsigned threads) {
+    const size_t n = arr.size();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, n / kSampleSortBaseCase)));
+    if (n <= kSampleSortBaseCase) {
+        std::sort(arr.begin(), arr.end());
+        return;
+    }
+
+    // At least four buckets per thread so the largest-first hand-out can balance
+    int logBuckets = sampleSortLogBuckets(n);
+    while (logBuckets < kMaxLogBuckets && (size_t(1) << logBuckets) < 4 * size_t(threads)) logBuckets++;
+    std::minstd_rand rng(static_cast<unsigned>(n));
+    SplitterTree tree = chooseSplitters(arr.data(), n, logBuckets, rng);
+    const size_t k = tree.bucketCount();
+
+    // Phase 1: each thread classifies its own stripe and counts per bucket
+    std::vector<uint8_t> oracle(n);
+    std::vector<size_t> counts(threads * k, 0);   // [thread][bucket]
+    auto stripeBegin = [&](unsigned t) { return n * t / threads; };
+    runOnThreads(threads, [&](unsigned t) {
+        profiler::ScopedSpan span("classify");
+        size_t begin = stripeBegin(t);
+        tree.classify(arr.data() + begin, stripeBegin(t + 1) - begin, oracle.data() + begin, &counts[t * k]);
+    });
+
+    // Bucket-major prefix sum: a thread's slice of bucket b follows the
+    // slices of lower-numbered threads, so each thread writes its own range
+    std::vector<size_t> bucketStart(k + 1, 0);
+    std::vector<size_t> offsets(threads * k);
+    size_t offset = 0;
+    for (size_t b = 0; b < k; b++) {
+        bucketStart[b] = offset;
+        for (unsigned t = 0; t < threads; t++) {
+            offsets[t * k + b] = offset;
+            offset += counts[t * k + b];
+        }
+    }
+    bucketStart[k] = n;
+
+    // Phase 2: per-thread scatter into the shared buffer, no synchronisation
+    std::vector<int> buffer(n);
+    runOnThreads(threads, [&](unsigned t) {
+        profiler::ScopedSpan span("scatter pass");
+        size_t* next = &offsets[t * k];
+        for (size_t i = stripeBegin(t); i < stripeBegin(t + 1); i++) buffer[next[oracle[i]]++] = arr[i];
+    });
+
+    // Phase 3: threads take buckets largest first and sort them back into arr
+    std::vector<size_t> order(k);
+    for (size_t b = 0; b < k; b++) order[b] = b;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+    });
+    std::atomic<size_t> nextBucket{0};
+    runOnThreads(threads, [&](unsigned t) {
+        profiler::ScopedSpan span("bucket sort");
+        std::minstd_rand bucketRng(static_cast<unsigned>(n) + t);
+        for (size_t slot = nextBucket++; slot < k; slot = nextBucket++) {
+            size_t b = order[slot];
+            size_t begin = bucketStart[b];
+            size_t size = bucketStart[b + 1] - begin;
+            std::memcpy(arr.data() + begin, buffer.data() + begin, size * sizeof(int));
+            if (!tree.equal[b]) sampleSortRange(arr.data() + begin, buffer.data() + begin, size, bucketRng);
+        }
+    });
+}
+
+void sampleSort(std::vector<int>& arr,
+               std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+               VisualizerState& state,
+               int threads) {
+    const int n = static_cast<int>(arr.size());
+    if (n < 2) return;
+
+    // One bucket per thread, rounded to a power of two for the splitter tree
+    int logBuckets = 1;
+    while ((1 << logBuckets) < threads && logBuckets < 3) logBuckets++;
+    const int k = 1 << logBuckets;
+    threads = k;
+
+    SortStats stats;
+    stats.timeComplexity = "O(n log n) work, O(n log n / p) per thread";
+    stats.spaceComplexity = "O(n)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto stripeBegin = [&](int t) { return n * t / threads; };
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    const int alpha = 2;
+    std::vector<int> sampleIndices(n);
+    for (int i = 0; i < n; i++) sampleIndices[i] = i;
+    std::shuffle(sampleIndices.begin(), sampleIndices.end(), gen);
+    sampleIndices.resize(std::min(n, alpha * k));
+    std::sort(sampleIndices.begin(), sampleIndices.end());
+
+    std::vector<int> sample;
+    state.discarded.assign(arr.size(), true);
+    for (int idx : sampleIndices) {
+        sample.push_back(arr[idx]);
+        state.discarded[idx] = false;
+    }
+    std::sort(sample.begin(), sample.end());
+    std::string sampleText;
+    for (int v : sample) sampleText += std::to_string(v) + " ";
+    callback(arr, -1, -1, "Oversampling: " + std::to_string(sample.size()) + " random elements (" +
+                          std::to_string(alpha) + " per bucket), sorted: " + sampleText);
+
+    std::vector<int> splitters;
+    for (int i = 0; i + 1 < k; i++) {
+        splitters.push_back(sample[std::min<int>((i + 1) * alpha, static_cast<int>(sample.size())) - 1]);
+    }
+    SplitterTree tree;
+    tree.logBuckets = logBuckets;
+    placeSplitters(tree, splitters);
+    std::string splitterText;
+    for (int v : splitters) splitterText += std::to_string(v) + " ";
+    std::string treeText = "root " + std::to_string(tree.tree[1]);
+    if (logBuckets > 1) treeText += ", children " + std::to_string(tree.tree[2]) + " / " + std::to_string(tree.tree[3]);
+    state.discarded.clear();
+    for (int t = 1; t < threads; t++) state.runBoundaries.push_back(stripeBegin(t));
+    callback(arr, -1, -1, "Splitters " + splitterText + "(" + treeText + "). Bucket b is sorted by thread b.\n"
+                          "Red bars: each of the " + std::to_string(threads) + " threads classifies its own stripe");
+
+    // Phase 1: classification, colouring each element by its destination thread
+    state.threadOf.assign(arr.size(), -1);
+    std::vector<int> bucket(arr.size());
+    std::vector<int> counts(threads * k, 0);
+    for (int t = 0; t < threads; t++) {
+        for (int i = stripeBegin(t); i < stripeBegin(t + 1); i++) {
+            std::string path;
+            size_t j = 1;
+            for (int level = 0; level < logBuckets; level++) {
+                stats.comparisons++;
+                bool right = arr[i] > tree.tree[j];
+                path += std::to_string(arr[i]) + (right ? " > " : " <= ") + std::to_string(tree.tree[j]) + ", ";
+                j = 2 * j + (right ? 1 : 0);
+            }
+            bucket[i] = static_cast<int>(j) - k;
+            counts[t * k + bucket[i]]++;
+            state.threadOf[i] = bucket[i];
+            callback(arr, i, -1, "Thread " + std::to_string(t) + " classifies " + std::to_string(arr[i]) + ": " +
+                                 path + "bucket " + std::to_string(bucket[i]) +
+                                 "\nComparisons: " + std::to_string(stats.comparisons));
+        }
+    }
+
+    // Prefix sum over (bucket, thread) pairs gives every thread private output ranges
+    std::vector<int> offsets(threads * k);
+    std::vector<int> bucketStart(k + 1, 0);
+    int offset = 0;
+    for (int b = 0; b < k; b++) {
+        bucketStart[b] = offset;
+        for (int t = 0; t < threads; t++) {
+            offsets[t * k + b] = offset;
+            offset += counts[t * k + b];
+        }
+    }
+    bucketStart[k] = n;
+
+    // Phase 2: scatter; grey slots have not been written yet. The callback
+    // may copy output into arr (the visualizer's array is usually arr
+    // itself), so read from a snapshot taken before the first scatter step.
+    const std::vector<int> input = arr;
+    std::vector<int> output(input);
+    std::vector<int> outputOwner(arr.size(), -1);
+    state.discarded.assign(arr.size(), true);
+    state.runBoundaries.assign(bucketStart.begin() + 1, bucketStart.end() - 1);
+    for (int t = 0; t < threads; t++) {
+        std::string moves;
+        for (int i = stripeBegin(t); i < stripeBegin(t + 1); i++) {
+            int dest = offsets[t * k + bucket[i]]++;
+            output[dest] = input[i];
+            outputOwner[dest] = bucket[i];
+            state.discarded[dest] = false;
+            moves += std::to_string(input[i]) + "->" + std::to_string(dest) + " ";
+        }
+        state.threadOf = outputOwner;
+        callback(output, -1, -1, "Thread " + std::to_string(t) + " scatters its stripe into its own slots: " +
+                                 (moves.empty() ? std::string("(empty stripe)") : moves));
+    }
+    arr = output;
+    state.discarded.clear();
+
+    // Phase 3: every thread sorts its bucket independently
+    for (int b = 0; b < k; b++) {
+        int begin = bucketStart[b];
+        int end = bucketStart[b + 1];
+        if (tree.equal[b]) {
+            callback(arr, -1, -1, "Thread " + std::to_string(b) + " skips bucket " + std::to_string(b) +
+                                  ": it only holds the repeated splitter " + std::to_string(splitters[b]) +
+                                  ", so its " + std::to_string(end - begin) + " elements are already in order");
+            continue;
+        }
+        for (int i = begin + 1; i < end; i++) {
+            int key = arr[i];
+            int j = i - 1;
+            while (j >= begin && (stats.comparisons++, arr[j] > key)) {
+                arr[j + 1] = arr[j];
+                stats.swaps++;
+                j--;
+            }
+            arr[j + 1] = key;
+        }
+        callback(arr, -1, -1, "Thread " + std::to_string(b) + " sorts bucket " + std::to_string(b) +
+                              " (indices " + std::to_string(begin) + "-" + std::to_string(end - 1) +
+                              ", " + std::to_string(end - begin) + " elements) in parallel with the others");
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    state.runBoundaries.clear();
+    callback(arr, -1, -1, "Sample Sort Complete!\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
+                          "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                          "Swaps: " + std::to_string(stats.swaps) + "\n" +
+                          "Time Complexity: " + stats.timeComplexity + "\n" +
+                          "Space Complexity: " + stats.spaceComplexity);
+    state.threadOf.clear();
+}
+
+
+namespace {
+
+// Index of the largest of the children starting at `first`; the selects
+// compile to conditional moves. A full node is reduced pairwise, so the
+// dependency chain is log2(D) selects long instead of D-1.
+template <int D>
+size_t largestChild(const int* h, size_t first, size_t size) {
+    if (first + D <= size) {
+        size_t index[D];
+        for (int c = 0; c < D; c++) index[c] = first + c;
+        for (int width = D / 2; width > 0; width /= 2) {
+            for (int c = 0; c < width; c++) {
+                index[c] = h[index[c + width]] > h[index[c]] ? index[c + width] : index[c];
+            }
+        }
+        return index[0];
+    }
+    size_t best = first;
+    size_t last = std::min(first + D, size);
+    for (size_t c = first + 1; c < last; c++) best = h[c] > h[best] ? c : best;
+    return best;
+}
+
+// The children of `node`'s children are one contiguous block of D*D
+// values; fetching it while this level is compared hides the next miss
+template <int D>
+void prefetchGrandchildren(const int* h, size_t node, size_t size) {
+    size_t block = D * (D * node + 1) + 1;
+    for (size_t offset = 0; offset < size_t(D * D) && block + offset < size; offset += 64 / sizeof(int)) {
+        prefetchRead(h + block + offset);
+    }
+}
+
+template <int D>
+void siftDownDAry(int* h, size_t size, size_t i) {
+    int value = h[i];
+    for (size_t first = D * i + 1; first < size; first = D * i + 1) {
+        prefetchGrandchildren<D>(h, i, size);
+        size_t child = largestChild<D>(h, first, size);
+        if (!(value < h[child])) break;
+        h[i] = h[child];
+        i = child;
+    }
+    h[i] = value;
+}
+
+// Floyd's bottom-up extraction: the hole left by the maximum follows the
+// larger children to a leaf without comparing against the displaced value,
+// which then climbs back only a level or two on average
+template <int D>
+void dAryHeapSort(int* h, size_t n) {
+    if (n < 2) return;
+    for (size_t i = (n - 2) / D + 1; i-- > 0;) siftDownDAry<D>(h, n, i);
+
+    for (size_t size = n - 1; size > 0; size--) {
+        int value = h[size];
+        h[size] = h[0];
+        size_t hole = 0;
+        for (size_t first = 1; first < size; first = D * hole + 1) {
+            prefetchGrandchildren<D>(h, hole, size);
+            size_t child = largestChild<D>(h, first, size);
+            h[hole] = h[child];
+            hole = child;
+        }
+        while (hole > 0) {
+            size_t parent = (hole - 1) / D;
+            if (!(h[parent] < value)) break;
+            h[hole] = h[parent];
+            hole = parent;
+        }
+        h[hole] = value;
+    }
+}
+
+} // namespace
+
+int heapArity(int requested) {
+    if (requested <= 2) return 2;
+    if (requested <= 4) return 4;
+    return 8;
+}
+
+void heapSort(std::vector<int>& arr, int arity) {
+    profiler::ScopedSpan span("heapSort");
+    switch (heapArity(arity)) {
+        case 2: dAryHeapSort<2>(arr.data(), arr.size()); break;
+        case 4: dAryHeapSort<4>(arr.data(), arr.size()); break;
+        default: dAryHeapSort<8>(arr.data(), arr.size()); break;
+    }
+}
+
+void heapSort(std::vector<int>& arr,
+             std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+             VisualizerState& state,
+             int arity) {
+    const int d = heapArity(arity);
+    const int n = static_cast<int>(arr.size());
+    if (n < 2) return;
+
+    SortStats stats;
+    stats.timeComplexity = "O(n log n) worst case";
+    stats.spaceComplexity = "O(1)";
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const std::string heapName = std::to_string(d) + "-ary heap";
+    state.heapArity = d;
+    state.heapSize = n;
+
+    // Sorted tail is greyed out in the array row and left out of the tree
+    std::string text;
+    auto show = [&](int i, int j, const auto&... parts) {
+        state.discarded.assign(arr.size(), false);
+        for (int idx = state.heapSize; idx < n; idx++) state.discarded[idx] = true;
+        callback(arr, i, j, setExplanation(text, parts..., "\nComparisons: ", stats.comparisons,
+                                           "\nSwaps: ", stats.swaps));
+    };
+    auto largest = [&](int first, int size) {
+        int best = first;
+        for (int c = first + 1; c < std::min(first + d, size); c++) {
+            stats.comparisons++;
+            if (arr[c] > arr[best]) best = c;
+        }
+        return best;
+    };
+
+    show(-1, -1, "Building a ", heapName, ": node i has children ", d, "i+1 .. ", d, "i+", d);
+    for (int i = (n - 2) / d; i >= 0; i--) {
+        int node = i;
+        int value = arr[node];
+        while (d * node + 1 < n) {
+            int child = largest(d * node + 1, n);
+            stats.comparisons++;
+            if (!(value < arr[child])) break;
+            arr[node] = arr[child];
+            stats.swaps++;
+            node = child;
+        }
+        arr[node] = value;
+        show(node, i, "Sifted ", value, " down from node ", i, " to node ", node);
+    }
+
+    std::string path;
+    for (int size = n - 1; size > 0; size--) {
+        int value = arr[size];
+        int maxValue = arr[0];
+        arr[size] = maxValue;
+        stats.swaps++;
+        state.heapSize = size;
+
+        // Bottom-up: the hole walks to a leaf, then the displaced value climbs
+        int hole = 0;
+        path = "0";
+        while (d * hole + 1 < size) {
+            int child = largest(d * hole + 1, size);
+            arr[hole] = arr[child];
+            hole = child;
+            path += " -> ";
+            appendPart(path, hole);
+        }
+        arr[hole] = value;
+        show(hole, size, "Max ", maxValue, " moved to index ", size, "; hole followed the larger children ",
+             path, " without comparing against ", value);
+
+        int leaf = hole;
+        while (hole > 0) {
+            int parent = (hole - 1) / d;
+            stats.comparisons++;
+            if (!(arr[parent] < value)) break;
+            arr[hole] = arr[parent];
+            stats.swaps++;
+            hole = parent;
+        }
+        arr[hole] = value;
+        if (hole != leaf) {
+            show(hole, leaf, value, " climbed back up from node ", leaf, " to node ", hole);
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeTaken = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    state.heapSize = 0;
+    state.discarded.clear();
+    callback(arr, -1, -1, "Heap Sort (" + heapName + ") Complete!\nTime: " + std::to_string(stats.timeTaken) + "ms\n" +
+                          "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                          "Swaps: " + std::to_string(stats.swaps) + "\n" +
+                          "Time Complexity: " + stats.timeComplexity + "\n" +
+                          "Space Complexity: " + stats.spaceComplexity);
+    state.heapArity = 0;
+}
@@ -1,49 +1,256 @@
-#pragma once
-
-#ifndef SORT_ALGORITHMS_HPP
-#define SORT_ALGORITHMS_HPP
-
-#include <vector>
-#include <functional>
-#include <string>
-#include "Visualizer.hpp"
-
-void bubbleSort(
-    std::vector<int>& arr,
-    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback
-);
-
-void insertionSort(
-    std::vector<int>& arr,
-    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback
-);
-
-void quickSort(
-    std::vector<int>& arr,
-    VisualizerState& state,
-    int low,
-    int high,
-    bool isInitialCall = true
-);
-
-void bucketSort(
-    std::vector<float>& arr,
-    SortStats& stats,
-    VisualizerState& state,
-    std::function<void(const std::vector<std::vector<float>>&, const std::string&)> stepCallback
-);
-
-void radixSort(
-    std::vector<int>& arr,
-    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback
-);
-
-void countingSort(
-    std::vector<int>& arr,
-    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
-    VisualizerState& state
-);
-
-std::string formatFloatArray(const std::vector<float>& arr);
-
+#pragma once
+
+#ifndef SORT_ALGORITHMS_HPP
+#define SORT_ALGORITHMS_HPP
+
+#include <vector>
+#include <functional>
+#include <string>
+#include <cstdint>
+#include "VisualizerState.hpp"
+#include "StepGenerator.hpp"
+#include "SortMemory.hpp"
+
+// Contiguous storage for string keys. Each string also caches its first
+// 8 bytes as a big-endian word so most comparisons never leave `prefixes`.
+struct StringArena {
+    std::vector<char> chars;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    std::vector<uint64_t> prefixes;
+
+    void assign(const std::vector<std::string>& strings);
+    std::string str(uint32_t id) const;
+    int charAt(uint32_t id, int depth) const;      // -1 past the end
+    uint64_t wordAt(uint32_t id, int depth) const; // 8 bytes from depth, zero padded
+    int compareFrom(uint32_t a, uint32_t b, int depth) const;
+};
+
+// Summary of an int input gathered by analyzeInput. Runs and min/max come
+// from a single vectorized pass; duplicates and inversions are sampled.
+struct InputProfile {
+    size_t n = 0;
+    int minValue = 0;
+    int maxValue = 0;
+    long long range = 0;
+    size_t ascendingRuns = 0;
+    size_t descendingRuns = 0;
+    double duplicateRatio = 0.0;
+    double estimatedInversions = 0.0;
+};
+
+enum class SortChoice {
+    Insertion,
+    Counting,
+    Radix,
+    NaturalMerge,
+    Introsort,
+    ThreeWay
+};
+
+InputProfile analyzeInput(const std::vector<int>& arr);
+SortChoice chooseAlgorithm(const InputProfile& profile);
+const char* sortChoiceName(SortChoice choice);
+std::string describeProfile(const InputProfile& profile, SortChoice choice);
+
+// Tuning for naturalMergeSort. minRun 0 uses Timsort's rule (32..64 from n);
+// the visualizer lowers both so runs and galloping show up on 10 elements.
+struct TimSortParams {
+    int minRun = 0;
+    int minGallop = 7;
+};
+
+// Headless Timsort-style natural merge sort (stable)
+void naturalMergeSort(std::vector<int>& arr, const TimSortParams& params = TimSortParams());
+
+void naturalMergeSort(
+    std::vector<int>& arr,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state,
+    const TimSortParams& params = TimSortParams()
+);
+
+// Introselect: Lomuto partitioning (as in quickSort) around a median-of-three
+// pivot, falling back to heap selection past 2*log2(n) levels. Afterwards
+// arr[k] holds the k-th smallest value with smaller ones before it.
+int quickSelect(std::vector<int>& arr, int k);
+
+// The k smallest values in ascending order, keeping only a k-element max-heap
+std::vector<int> topK(const std::vector<int>& arr, int k);
+
+// Sorts arr[0, k) into the k smallest values; the rest is left unordered
+void partialSort(std::vector<int>& arr, int k);
+
+void quickSelect(
+    std::vector<int>& arr,
+    int k,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state
+);
+
+void topK(
+    std::vector<int>& arr,
+    int k,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state
+);
+
+void partialSort(
+    std::vector<int>& arr,
+    int k,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state
+);
+
+// Parallel super scalar sample sort: splitters from a random oversample,
+// branchless classification through a splitter tree, a per-thread scatter
+// into disjoint bucket slices, then buckets sorted concurrently (recursing
+// sequentially while they are large). threads 0 uses every hardware thread.
+void parallelSampleSort(std::vector<int>& arr, unsigned threads = 0);
+
+// The same three phases on a small array, with the threads run one after
+// another so each step can be shown. Uses one bucket per thread (rounded up
+// to a power of two, at most 8); elements are coloured by the thread that
+// will sort their bucket.
+void sampleSort(
+    std::vector<int>& arr,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state,
+    int threads = 4
+);
+
+// Arity actually used for a requested one: 2, 4 or 8
+int heapArity(int requested);
+
+// d-ary heapsort with Floyd's bottom-up extraction. Wider nodes make the
+// heap shallower and put all children of a node in one cache line (d = 4
+// on 64-byte lines); the grandchildren block is prefetched each level.
+void heapSort(std::vector<int>& arr, int arity = 4);
+
+void heapSort(
+    std::vector<int>& arr,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state,
+    int arity = 4
+);
+
+// Knobs for the headless radix, counting and bucket kernels. Their
+// scatter passes write all over arrays far larger than the TLB covers, so
+// at 10^7+ elements the page size, prefetching each destination a few
+// elements ahead and staging writes per digit in cache-line buffers
+// decide the throughput. The default is all off.
+struct ScatterTuning {
+    sortmem::PageMode pages = sortmem::PageMode::Default;  // scratch buffers and the array itself
+    int prefetchDistance = 0;     // elements ahead whose destination is prefetched; 0 is off
+    bool writeCombining = false;  // copy out whole 64-byte lines per digit
+};
+
+// Everything on from kLargeScatterElements up, off below
+constexpr size_t kLargeScatterElements = size_t(1) << 22;
+ScatterTuning scatterTuningFor(size_t n);
+
+// Headless kernels (no callbacks). radixSort is byte-wise LSD on the
+// sign-flipped key; countingSort handles any int range it can allocate;
+// bucketSort expects keys in [0, 1) like the visual one (others are
+// clamped into the end buckets) and scatters through 256 coarse ranges
+// first so that pass can be write-combined.
+void radixSort(std::vector<int>& arr, const ScatterTuning& tuning = ScatterTuning());
+void countingSort(std::vector<int>& arr, const ScatterTuning& tuning = ScatterTuning());
+void bucketSort(std::vector<float>& arr, const ScatterTuning& tuning = ScatterTuning());
+
+// Headless kernel for a dispatcher choice (no callbacks, no step records)
+void runSortChoice(std::vector<int>& arr, SortChoice choice);
+
+void bubbleSort(
+    std::vector<int>& arr,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback
+);
+
+void insertionSort(
+    std::vector<int>& arr,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback
+);
+
+// Lazy QuickSort: each next() runs the partition loop only as far as the
+// following step, so the first frame costs the same for any n. The step
+// it yields keeps its buffers in `memory`.
+StepGenerator<QuickSortStep> quickSortStepGenerator(
+    std::vector<int> arr,
+    int low,
+    int high,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+);
+
+// Eager form: drains quickSortStepGenerator into state.quickSortSteps.
+void quickSort(
+    std::vector<int>& arr,
+    VisualizerState& state,
+    int low,
+    int high,
+    bool isInitialCall = true
+);
+
+// Headless kernel with the same Lomuto partition around the last element,
+// on an explicit stack of ranges. Like the visual one it is O(n^2) on
+// presorted input and on long runs of equal keys.
+void quickSort(std::vector<int>& arr);
+
+void bucketSort(
+    std::vector<float>& arr,
+    SortStats& stats,
+    VisualizerState& state,
+    std::function<void(const BucketList&, const std::string&)> stepCallback
+);
+
+// The output buffer shared by every digit pass comes from `memory`
+void radixSort(
+    std::vector<int>& arr,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+);
+
+void countingSort(
+    std::vector<int>& arr,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state
+);
+
+// LSD radix sort on IEEE-754 bit patterns. Keys are mapped with the
+// sign-flip transform so negatives, -0.0 (before +0.0) and infinities land
+// in numeric order; NaNs of either sign are placed after +infinity.
+void floatRadixSort(
+    std::vector<float>& arr,
+    std::function<void(const std::vector<float>&, int, int, const std::string&)> callback
+);
+
+void doubleRadixSort(
+    std::vector<double>& arr,
+    std::function<void(const std::vector<double>&, int, int, const std::string&)> callback
+);
+
+void multikeyQuickSort(
+    std::vector<std::string>& arr,
+    std::function<void(const std::vector<std::string>&, int, int, const std::string&)> callback,
+    VisualizerState& state
+);
+
+void msdRadixSort(
+    std::vector<std::string>& arr,
+    std::function<void(const std::vector<std::string>&, int, int, const std::string&)> callback,
+    VisualizerState& state,
+    int insertionCutoff = 4
+);
+
+// Shows the analysis in the explanation panel, then runs the visual
+// version of the chosen algorithm
+void adaptiveSort(
+    std::vector<int>& arr,
+    const InputProfile& profile,
+    SortChoice choice,
+    std::function<void(const std::vector<int>&, int, int, const std::string&)> callback,
+    VisualizerState& state
+);
+
+std::string formatFloatArray(const std::vector<float>& arr);
+
 #endif // SORT_ALGORITHMS_HPP
\ No newline at end of file
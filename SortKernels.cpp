@@ -0,0 +1,127 @@
+#include "SortKernels.hpp"
+#include "SortAlgorithms.hpp"
+#include "SortPlugin.h"
+#include <algorithm>
+#include <cstdint>
+
+#if defined(SORT_WITH_PARALLEL_STL) || defined(_MSC_VER)
+#include <execution>
+#define SORT_KERNELS_PARALLEL_STL 1
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+static_assert(sizeof(int) == sizeof(int32_t), "plug-in kernels sort int arrays in place as int32_t");
+
+namespace {
+
+std::vector<SortKernel>& registry() {
+    static std::vector<SortKernel> kernels = [] {
+        std::vector<SortKernel> builtIn;
+        builtIn.push_back({"radixSort", "built-in", true,
+                           [](std::vector<int>& arr) { runSortChoice(arr, SortChoice::Radix); }});
+        builtIn.push_back({"quickSort", "built-in", false,
+                           [](std::vector<int>& arr) { quickSort(arr); }, true});
+        builtIn.push_back({"naturalMergeSort", "built-in", true,
+                           [](std::vector<int>& arr) { naturalMergeSort(arr); }});
+        builtIn.push_back({"heapSort(d=4)", "built-in", false,
+                           [](std::vector<int>& arr) { heapSort(arr, 4); }});
+        builtIn.push_back({"parallelSampleSort", "built-in", false,
+                           [](std::vector<int>& arr) { parallelSampleSort(arr); }});
+        builtIn.push_back({"std::sort", "std", false,
+                           [](std::vector<int>& arr) { std::sort(arr.begin(), arr.end()); }});
+        builtIn.push_back({"std::stable_sort", "std", true,
+                           [](std::vector<int>& arr) { std::stable_sort(arr.begin(), arr.end()); }});
+#ifdef SORT_KERNELS_PARALLEL_STL
+        builtIn.push_back({"std::sort(par_unseq)", "std", false, [](std::vector<int>& arr) {
+                               std::sort(std::execution::par_unseq, arr.begin(), arr.end());
+                           }});
+#endif
+        return builtIn;
+    }();
+    return kernels;
+}
+
+void* openLibrary(const std::string& path, std::string& error) {
+#ifdef _WIN32
+    HMODULE library = LoadLibraryA(path.c_str());
+    if (!library) error = "LoadLibrary failed with error " + std::to_string(GetLastError());
+    return reinterpret_cast<void*>(library);
+#else
+    void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library) error = dlerror();
+    return library;
+#endif
+}
+
+void* findSymbol(void* library, const char* name) {
+#ifdef _WIN32
+    return reinterpret_cast<void*>(GetProcAddress(reinterpret_cast<HMODULE>(library), name));
+#else
+    return dlsym(library, name);
+#endif
+}
+
+void closeLibrary(void* library) {
+#ifdef _WIN32
+    FreeLibrary(reinterpret_cast<HMODULE>(library));
+#else
+    dlclose(library);
+#endif
+}
+
+} // namespace
+
+const std::vector<SortKernel>& sortKernels() {
+    return registry();
+}
+
+const SortKernel* findSortKernel(const std::string& name) {
+    for (const SortKernel& kernel : registry()) {
+        if (kernel.name == name) return &kernel;
+    }
+    return nullptr;
+}
+
+bool loadSortPlugin(const std::string& path, std::string& error) {
+    void* library = openLibrary(path, error);
+    if (!library) return false;
+
+    auto fail = [&](const std::string& message) {
+        error = path + ": " + message;
+        closeLibrary(library);
+        return false;
+    };
+
+    auto entry = reinterpret_cast<SortPluginInfoFn>(findSymbol(library, SORT_PLUGIN_ENTRY));
+    if (!entry) return fail("no " SORT_PLUGIN_ENTRY " export");
+    const SortPluginInfo* info = entry();
+    if (!info) return fail(SORT_PLUGIN_ENTRY " returned null");
+    if (info->abi_version != SORT_PLUGIN_ABI_VERSION) {
+        return fail("built for plug-in ABI " + std::to_string(info->abi_version) + ", expected " +
+                    std::to_string(SORT_PLUGIN_ABI_VERSION));
+    }
+
+    std::vector<SortKernel> loaded;
+    for (uint32_t i = 0; i < info->kernel_count; i++) {
+        const SortPluginKernel& exported = info->kernels[i];
+        if (!exported.name || !exported.sort_int32) return fail("kernel " + std::to_string(i) + " is incomplete");
+        std::string name = exported.name;
+        bool taken = findSortKernel(name) != nullptr ||
+                     std::any_of(loaded.begin(), loaded.end(), [&](const SortKernel& k) { return k.name == name; });
+        if (taken) return fail("kernel name \"" + name + "\" is already registered");
+
+        auto sortInt32 = exported.sort_int32;
+        loaded.push_back({name, path, exported.stable != 0, [sortInt32](std::vector<int>& arr) {
+                              sortInt32(reinterpret_cast<int32_t*>(arr.data()), arr.size());
+                          }});
+    }
+
+    registry().insert(registry().end(), loaded.begin(), loaded.end());
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef SORT_KERNELS_HPP
+#define SORT_KERNELS_HPP
+
+#include <vector>
+#include <string>
+#include <functional>
+
+// Registry of headless int sort kernels, so hand-written algorithms, the
+// standard library and plug-ins (SortPlugin.h) can be timed and their heap
+// allocations counted on identical inputs.
+//
+// std::sort(par_unseq) is registered only when built with
+// -DSORT_WITH_PARALLEL_STL (libstdc++ then also needs -ltbb), or on MSVC.
+struct SortKernel {
+    std::string name;
+    std::string origin;   // "built-in", "std", or the plug-in path
+    bool stable = false;
+    std::function<void(std::vector<int>&)> run;
+    // O(n^2) on presorted input or many equal keys; the benchmark times
+    // such kernels only on random input once n gets large
+    bool quadraticWorstCase = false;
+};
+
+// Built-in and standard-library kernels first, then plug-ins in load order
+const std::vector<SortKernel>& sortKernels();
+const SortKernel* findSortKernel(const std::string& name);
+
+// Registers every kernel the library exports. Returns false and sets
+// `error` if it cannot be opened, has no sort_plugin_info, was built for
+// another ABI version or reuses a registered name; nothing is registered
+// then. A loaded library stays loaded for the life of the process.
+bool loadSortPlugin(const std::string& path, std::string& error);
+
+#endif // SORT_KERNELS_HPP
@@ -0,0 +1,317 @@
+#include "SortMemory.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <utility>
+#ifdef __linux__
+#include <sys/mman.h>
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE 25
+#endif
+#endif
+
+namespace sortmem {
+
+namespace {
+
+std::atomic<size_t> allocationCount{0};
+std::atomic<size_t> allocatedBytes{0};
+std::atomic<size_t> liveBytes{0};
+std::atomic<size_t> peakBytes{0};
+
+// Each block is prefixed with its size so the unsized delete can account for it
+constexpr size_t kHeader = alignof(std::max_align_t);
+
+void recordAlloc(size_t size) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void* trackedAlloc(size_t size) noexcept {
+    void* raw = std::malloc(size + kHeader);
+    if (!raw) return nullptr;
+    *static_cast<size_t*>(raw) = size;
+    recordAlloc(size);
+    return static_cast<char*>(raw) + kHeader;
+}
+
+void trackedFree(void* ptr) noexcept {
+    if (!ptr) return;
+    void* raw = static_cast<char*>(ptr) - kHeader;
+    liveBytes.fetch_sub(*static_cast<size_t*>(raw), std::memory_order_relaxed);
+    std::free(raw);
+}
+
+// Over-aligned blocks keep the malloc pointer just below the size word
+void* trackedAlignedAlloc(size_t size, size_t alignment) noexcept {
+    if (alignment < kHeader) alignment = kHeader;
+    void* raw = std::malloc(size + kHeader + alignment - 1);
+    if (!raw) return nullptr;
+    uintptr_t address = reinterpret_cast<uintptr_t>(raw) + kHeader;
+    address = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    static_cast<void**>(reinterpret_cast<void*>(address))[-2] = raw;
+    static_cast<size_t*>(reinterpret_cast<void*>(address))[-1] = size;
+    recordAlloc(size);
+    return reinterpret_cast<void*>(address);
+}
+
+void trackedAlignedFree(void* ptr) noexcept {
+    if (!ptr) return;
+    liveBytes.fetch_sub(static_cast<size_t*>(ptr)[-1], std::memory_order_relaxed);
+    std::free(static_cast<void**>(ptr)[-2]);
+}
+
+void* allocOrThrow(size_t size, size_t alignment = 0) {
+    if (size == 0) size = 1;
+    for (;;) {
+        void* ptr = alignment ? trackedAlignedAlloc(size, alignment) : trackedAlloc(size);
+        if (ptr) return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+// A first block big enough for the default 10-40 element views, so small
+// sorts never reach the heap through the arena at all
+alignas(std::max_align_t) unsigned char initialBlock[256 * 1024];
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+
+    size_t bytes = 0;
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override {
+        bytes += size;
+        return upstream->allocate(size, alignment);
+    }
+    void do_deallocate(void* ptr, size_t size, size_t alignment) override {
+        upstream->deallocate(ptr, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream;
+};
+
+std::pmr::monotonic_buffer_resource& monotonic() {
+    static std::pmr::monotonic_buffer_resource resource(initialBlock, sizeof(initialBlock),
+                                                        std::pmr::new_delete_resource());
+    return resource;
+}
+
+CountingResource& sortArena() {
+    static CountingResource resource(&monotonic());
+    return resource;
+}
+
+constexpr size_t kHugePage = 2 * 1024 * 1024;
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+#ifdef __linux__
+// `data` and `bytes` are 2 MiB aligned. Collapsing copies already faulted
+// pages into huge ones; fresh mappings skip it and fault in huge pages.
+PageMode adviseRange(void* data, size_t bytes, PageMode mode, bool collapse) {
+    if (mode == PageMode::Small) {
+        return madvise(data, bytes, MADV_NOHUGEPAGE) == 0 ? PageMode::Small : PageMode::Default;
+    }
+    std::string policy = transparentHugePages();
+    if (policy == "never" || policy == "unsupported") return PageMode::Default;
+    if (madvise(data, bytes, MADV_HUGEPAGE) != 0) return PageMode::Default;
+    // Fails on kernels before 6.1; the pages then turn huge when khugepaged gets to them
+    if (collapse) madvise(data, bytes, MADV_COLLAPSE);
+    return PageMode::Transparent;
+}
+#endif
+
+} // namespace
+
+const char* pageModeName(PageMode mode) {
+    switch (mode) {
+        case PageMode::Default: return "default";
+        case PageMode::Small: return "4 KiB";
+        case PageMode::Transparent: return "THP";
+        case PageMode::Explicit: return "hugetlbfs";
+    }
+    return "?";
+}
+
+std::string transparentHugePages() {
+    static const std::string policy = [] {
+        std::ifstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string line;
+        if (!std::getline(in, line)) return std::string("unsupported");
+        size_t open = line.find('[');
+        size_t close = line.find(']', open);
+        return open == std::string::npos || close == std::string::npos ? line
+                                                                       : line.substr(open + 1, close - open - 1);
+    }();
+    return policy;
+}
+
+PageBuffer::PageBuffer(size_t bytes, PageMode requested) : bytes(bytes) {
+    if (bytes == 0) return;
+    if (bytes < kHugePage) requested = PageMode::Default;
+#ifdef __linux__
+    if (requested == PageMode::Explicit) {
+        // Needs a reserved pool (vm.nr_hugepages); most systems have none
+        size_t length = roundUp(bytes, kHugePage);
+        void* pages = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (pages != MAP_FAILED) {
+            data = mapping = pages;
+            mappedBytes = length;
+            mode = PageMode::Explicit;
+            recordAlloc(mappedBytes);
+            return;
+        }
+        requested = PageMode::Transparent;
+    }
+    if (requested != PageMode::Default) {
+        // One extra huge page of slack so the buffer can start on a 2 MiB boundary
+        size_t length = roundUp(bytes, kHugePage) + kHugePage;
+        void* pages = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pages != MAP_FAILED) {
+            mapping = pages;
+            mappedBytes = length;
+            data = reinterpret_cast<void*>(roundUp(reinterpret_cast<uintptr_t>(pages), kHugePage));
+            mode = adviseRange(data, roundUp(bytes, kHugePage), requested, false);
+            recordAlloc(mappedBytes);
+            return;
+        }
+    }
+#else
+    (void)requested;
+#endif
+    data = ::operator new(bytes);
+}
+
+PageBuffer::~PageBuffer() {
+    release();
+}
+
+PageBuffer::PageBuffer(PageBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+PageBuffer& PageBuffer::operator=(PageBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        data = other.data;
+        bytes = other.bytes;
+        mapping = other.mapping;
+        mappedBytes = other.mappedBytes;
+        mode = other.mode;
+        other.data = other.mapping = nullptr;
+        other.bytes = other.mappedBytes = 0;
+    }
+    return *this;
+}
+
+void PageBuffer::release() {
+#ifdef __linux__
+    if (mapping) {
+        munmap(mapping, mappedBytes);
+        liveBytes.fetch_sub(mappedBytes, std::memory_order_relaxed);
+        data = mapping = nullptr;
+        return;
+    }
+#endif
+    ::operator delete(data);
+    data = nullptr;
+}
+
+PageMode advisePages(void* data, size_t bytes, PageMode mode) {
+#ifdef __linux__
+    uintptr_t begin = roundUp(reinterpret_cast<uintptr_t>(data), kHugePage);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(uintptr_t(kHugePage) - 1);
+    if (mode == PageMode::Default || end <= begin) return PageMode::Default;
+    return adviseRange(reinterpret_cast<void*>(begin), end - begin, mode, true);
+#else
+    (void)data;
+    (void)bytes;
+    (void)mode;
+    return PageMode::Default;
+#endif
+}
+
+Counters counters() {
+    Counters result;
+    result.allocations = allocationCount.load(std::memory_order_relaxed);
+    result.bytes = allocatedBytes.load(std::memory_order_relaxed);
+    result.liveBytes = liveBytes.load(std::memory_order_relaxed);
+    result.peakBytes = peakBytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+Counters since(const Counters& before, const Counters& after) {
+    Counters result = after;
+    result.allocations = after.allocations - before.allocations;
+    result.bytes = after.bytes - before.bytes;
+    return result;
+}
+
+std::pmr::memory_resource* arena() {
+    return &sortArena();
+}
+
+void releaseArena() {
+    monotonic().release();
+    sortArena().bytes = 0;
+}
+
+size_t arenaBytes() {
+    return sortArena().bytes;
+}
+
+} // namespace sortmem
+
+void* operator new(std::size_t size) { return sortmem::allocOrThrow(size); }
+void* operator new[](std::size_t size) { return sortmem::allocOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return sortmem::trackedAlloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return sortmem::trackedAlloc(size ? size : 1);
+}
+void operator delete(void* ptr) noexcept { sortmem::trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { sortmem::trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { sortmem::trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { sortmem::trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { sortmem::trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { sortmem::trackedFree(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return sortmem::allocOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return sortmem::allocOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return sortmem::trackedAlignedAlloc(size ? size : 1, static_cast<size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return sortmem::trackedAlignedAlloc(size ? size : 1, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr, std::align_val_t) noexcept { sortmem::trackedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { sortmem::trackedAlignedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { sortmem::trackedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { sortmem::trackedAlignedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    sortmem::trackedAlignedFree(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    sortmem::trackedAlignedFree(ptr);
+}
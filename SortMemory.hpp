@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef SORT_MEMORY_HPP
+#define SORT_MEMORY_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+// Heap accounting and the per-sort arena.
+//
+// SortMemory.cpp replaces the global operator new/delete, so every heap
+// allocation in the process is counted once it is linked in. Sort
+// temporaries and QuickSort step records come from arena() instead of the
+// heap; releaseArena() hands all of it back at once when the view resets.
+namespace sortmem {
+
+struct Counters {
+    size_t allocations = 0;  // operator new calls since start-up
+    size_t bytes = 0;        // bytes requested by those calls
+    size_t liveBytes = 0;    // requested and not yet freed
+    size_t peakBytes = 0;    // high-water mark of liveBytes
+};
+
+Counters counters();
+
+// Difference between two snapshots; live and peak are taken from `after`
+Counters since(const Counters& before, const Counters& after);
+
+// Monotonic and single-threaded: deallocate is a no-op, so only use it for
+// memory that dies with the current sort.
+std::pmr::memory_resource* arena();
+
+// Frees every arena block in one step. All containers built on arena() must
+// already be gone.
+void releaseArena();
+
+// Bytes handed out by the arena since the last release
+size_t arenaBytes();
+
+// Page size behind large sort buffers. Scatter passes write to n/16
+// distinct cache lines spread over the whole array, so at 10^8 elements
+// nearly every write misses the TLB with 4 KiB pages.
+enum class PageMode {
+    Default,      // whatever operator new and the system give
+    Small,        // 4 KiB pages; opts out of transparent huge pages
+    Transparent,  // 2 MiB transparent huge pages via madvise
+    Explicit      // hugetlbfs pages (MAP_HUGETLB), falling back to Transparent
+};
+
+const char* pageModeName(PageMode mode);
+
+// The kernel's transparent huge page policy ("always", "madvise",
+// "never"), or "unsupported" where there is none
+std::string transparentHugePages();
+
+// Scratch memory for the large-array kernels. Anything but Default is an
+// anonymous mapping outside operator new (still counted as one
+// allocation); buffers under one huge page always come from operator new.
+// When the requested pages are not available the buffer falls back one
+// mode at a time; granted() says what was actually used.
+class PageBuffer {
+public:
+    PageBuffer() = default;
+    PageBuffer(size_t bytes, PageMode mode);
+    ~PageBuffer();
+    PageBuffer(PageBuffer&& other) noexcept;
+    PageBuffer& operator=(PageBuffer&& other) noexcept;
+    PageBuffer(const PageBuffer&) = delete;
+    PageBuffer& operator=(const PageBuffer&) = delete;
+
+    template <typename T>
+    T* as() const { return static_cast<T*>(data); }
+    size_t size() const { return bytes; }
+    PageMode granted() const { return mode; }
+
+private:
+    void release();
+
+    void* data = nullptr;
+    size_t bytes = 0;
+    void* mapping = nullptr;  // start of the mmap, below data when aligned up
+    size_t mappedBytes = 0;
+    PageMode mode = PageMode::Default;
+};
+
+// Applies `mode` to memory the caller already owns, such as the array being
+// sorted. Only the 2 MiB aligned interior can change page size, and pages
+// already faulted in are collapsed where the kernel supports it
+// (MADV_COLLAPSE, Linux 6.1). Returns the mode that took effect.
+PageMode advisePages(void* data, size_t bytes, PageMode mode);
+
+} // namespace sortmem
+
+#endif // SORT_MEMORY_HPP
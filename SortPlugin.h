@@ -0,0 +1,47 @@
+#ifndef SORT_PLUGIN_H
+#define SORT_PLUGIN_H
+
+/* C ABI for sort kernels loaded at run time. A plug-in is a shared library
+ * exporting sort_plugin_info(); the benchmark (--plugin path) and the
+ * visualizer (plug-in paths on the command line) register its kernels next
+ * to the built-in ones and run them on the same inputs. Only this header is
+ * needed to build one:
+ *   cc -O2 -shared -fPIC my_kernels.c -o my_kernels.so
+ * See sort_plugin_demo.c for a complete example. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SORT_PLUGIN_ABI_VERSION 1
+#define SORT_PLUGIN_ENTRY "sort_plugin_info"
+
+#ifdef _WIN32
+#define SORT_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define SORT_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SortPluginKernel {
+    const char* name;                            /* unique across loaded kernels */
+    int stable;                                  /* nonzero if equal keys keep their order */
+    void (*sort_int32)(int32_t* data, size_t n); /* ascending, in place */
+} SortPluginKernel;
+
+/* Returned by sort_plugin_info(); must stay valid while the library is loaded */
+typedef struct SortPluginInfo {
+    uint32_t abi_version;                        /* SORT_PLUGIN_ABI_VERSION */
+    uint32_t kernel_count;
+    const SortPluginKernel* kernels;
+} SortPluginInfo;
+
+typedef const SortPluginInfo* (*SortPluginInfoFn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SORT_PLUGIN_H */
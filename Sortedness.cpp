@@ -0,0 +1,245 @@
+#include "Sortedness.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+// Counters across all block trees; blocks grow past sqrt(n) to stay under it
+constexpr size_t kMaxTreeCounters = size_t(1) << 22;
+
+} // namespace
+
+void SortednessTracker::reset(const std::vector<int>& arr) {
+    const size_t n = arr.size();
+    array = arr;
+    sorted = arr;
+    std::sort(sorted.begin(), sorted.end());
+    ranks.resize(n);
+    for (size_t i = 0; i < n; i++) ranks[i] = rankOf(arr[i]);
+    target = sorted;
+    targetCount.assign(n, 0);
+    for (int rank : ranks) targetCount[rank]++;
+    balance.assign(n, 0);
+    unbalanced = 0;
+
+    blockSize = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(n))));
+    while ((n + blockSize - 1) / blockSize * (n + 1) > kMaxTreeCounters) blockSize *= 2;
+    const size_t blocks = (n + blockSize - 1) / blockSize;
+    trees.assign(blocks * (n + 1), 0);
+    for (size_t i = 0; i < n; i++) rankAdd(i / blockSize, ranks[i], 1);
+
+    current = SortednessMetrics();
+    current.n = n;
+
+    // Inversions once from scratch: each element against the larger ranks before it
+    std::vector<int> seen(n + 1, 0);
+    for (size_t j = 0; j < n; j++) {
+        long long notGreater = 0;
+        for (size_t k = ranks[j] + 1; k > 0; k -= k & (~k + 1)) notGreater += seen[k];
+        current.inversions += static_cast<long long>(j) - notGreater;
+        for (size_t k = ranks[j] + 1; k <= n; k += k & (~k + 1)) seen[k]++;
+    }
+
+    descents.clear();
+    runs.clear();
+    size_t runStart = 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (arr[i] > arr[i + 1]) {
+            descents.insert(i);
+            runs.insert(i + 1 - runStart);
+            runStart = i + 1;
+        }
+    }
+    if (n > 0) runs.insert(n - runStart);
+    current.longestRun = runs.empty() ? 0 : *runs.rbegin();
+
+    for (size_t i = 0; i < n; i++) current.inPlace += arr[i] == target[i];
+}
+
+void SortednessTracker::write(size_t index, int value) {
+    const size_t n = array.size();
+    if (index >= n || array[index] == value) return;
+
+    int rank = rankOf(value);
+    if (rank < 0) {
+        std::vector<int> next = array;
+        next[index] = value;
+        reset(next);
+        rebuildCount++;
+        return;
+    }
+
+    // Neither range includes `index`, so its old rank can stay in the trees
+    // until both counts are taken
+    int oldRank = ranks[index];
+    for (auto [changed, delta] : {std::pair{oldRank, -1}, std::pair{rank, 1}}) {
+        int& count = balance[changed];
+        unbalanced -= count != 0;
+        count += delta;
+        unbalanced += count != 0;
+    }
+    if (rank != oldRank) {
+        current.inversions += contribution(index, rank) - contribution(index, oldRank);
+        rankAdd(index / blockSize, oldRank, -1);
+        rankAdd(index / blockSize, rank, 1);
+        ranks[index] = rank;
+    }
+
+    current.inPlace -= array[index] == target[index];
+    current.inPlace += value == target[index];
+    array[index] = value;
+
+    if (index > 0) setDescent(index - 1, array[index - 1] > array[index]);
+    if (index + 1 < n) setDescent(index, array[index] > array[index + 1]);
+    current.longestRun = *runs.rbegin();
+}
+
+void SortednessTracker::sync() {
+    if (unbalanced == 0) return;
+    target.clear();
+    for (size_t rank = 0; rank < sorted.size(); rank++) {
+        targetCount[rank] += balance[rank];
+        balance[rank] = 0;
+        target.insert(target.end(), targetCount[rank], sorted[rank]);
+    }
+    unbalanced = 0;
+    current.inPlace = 0;
+    for (size_t i = 0; i < array.size(); i++) current.inPlace += array[i] == target[i];
+}
+
+int SortednessTracker::rankOf(int value) const {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), value);
+    if (it == sorted.end() || *it != value) return -1;
+    return static_cast<int>(it - sorted.begin());
+}
+
+int SortednessTracker::rankPrefix(size_t block, int rank) const {
+    const int* tree = trees.data() + block * (array.size() + 1);
+    int count = 0;
+    for (size_t k = rank; k > 0; k -= k & (~k + 1)) count += tree[k];
+    return count;
+}
+
+void SortednessTracker::rankAdd(size_t block, int rank, int delta) {
+    const size_t n = array.size();
+    int* tree = trees.data() + block * (n + 1);
+    for (size_t k = rank + 1; k <= n; k += k & (~k + 1)) tree[k] += delta;
+}
+
+// Positions [begin, end) holding a rank in [lowRank, highRank): whole
+// blocks from their trees, the ragged ends by scanning
+long long SortednessTracker::countRanks(size_t begin, size_t end, int lowRank, int highRank) const {
+    if (begin >= end || lowRank >= highRank) return 0;
+    long long count = 0;
+    size_t i = begin;
+    for (; i < end && i % blockSize != 0; i++) count += ranks[i] >= lowRank && ranks[i] < highRank;
+    for (; i + blockSize <= end; i += blockSize) {
+        size_t block = i / blockSize;
+        count += rankPrefix(block, highRank) - rankPrefix(block, lowRank);
+    }
+    for (; i < end; i++) count += ranks[i] >= lowRank && ranks[i] < highRank;
+    return count;
+}
+
+// Inversions the element at `index` would be part of if it had `rank`
+long long SortednessTracker::contribution(size_t index, int rank) const {
+    const int n = static_cast<int>(array.size());
+    return countRanks(0, index, rank + 1, n) + countRanks(index + 1, array.size(), 0, rank);
+}
+
+// Adding a descent at i splits the run around it in two; removing one
+// joins the runs on either side
+void SortednessTracker::setDescent(size_t index, bool descent) {
+    bool present = descents.count(index) > 0;
+    if (present == descent) return;
+
+    auto following = descents.upper_bound(index);
+    size_t end = following == descents.end() ? array.size() : *following + 1;
+    auto atOrAfter = descents.lower_bound(index);
+    size_t start = atOrAfter == descents.begin() ? 0 : *std::prev(atOrAfter) + 1;
+
+    if (descent) {
+        runs.erase(runs.find(end - start));
+        runs.insert(index + 1 - start);
+        runs.insert(end - index - 1);
+        descents.insert(index);
+    } else {
+        runs.erase(runs.find(index + 1 - start));
+        runs.erase(runs.find(end - index - 1));
+        runs.insert(end - start);
+        descents.erase(index);
+    }
+}
+
+void RunHistory::begin(const int* values, size_t count) {
+    tracker.reset(std::vector<int>(values, values + count));
+    samples.assign(1, tracker.metrics());
+    writes.clear();
+    stepEnd.assign(1, 0);
+    shown = 0;
+    logging = true;
+}
+
+void RunHistory::record(const int* values, size_t count) {
+    if (samples.empty() || count != tracker.values().size()) {
+        begin(values, count);
+        return;
+    }
+    if (shown + 1 != samples.size()) seek(samples.size() - 1);
+
+    const std::vector<int>& tracked = tracker.values();
+    for (size_t i = 0; i < count; i++) {
+        if (values[i] == tracked[i]) continue;
+        if (logging && writes.size() < kMaxLoggedWrites) {
+            writes.push_back({static_cast<uint32_t>(i), tracked[i], values[i]});
+        } else {
+            logging = false;
+        }
+        tracker.write(i, values[i]);
+    }
+    tracker.sync();
+    stepEnd.push_back(writes.size());
+    samples.push_back(tracker.metrics());
+    shown = samples.size() - 1;
+}
+
+void RunHistory::clear() {
+    tracker.reset({});
+    samples.clear();
+    writes.clear();
+    stepEnd.clear();
+    shown = 0;
+    logging = true;
+}
+
+const std::vector<int>& RunHistory::seek(size_t step) {
+    if (!logging || samples.empty()) return tracker.values();
+    step = std::min(step, samples.size() - 1);
+    while (shown > step) {
+        for (size_t w = stepEnd[shown]; w > stepEnd[shown - 1]; w--) {
+            tracker.write(writes[w - 1].index, writes[w - 1].before);
+        }
+        shown--;
+    }
+    while (shown < step) {
+        shown++;
+        for (size_t w = stepEnd[shown - 1]; w < stepEnd[shown]; w++) {
+            tracker.write(writes[w].index, writes[w].after);
+        }
+    }
+    tracker.sync();
+    return tracker.values();
+}
+
+std::vector<float> RunHistory::sortednessCurve(size_t maxPoints) const {
+    std::vector<float> curve;
+    if (samples.empty() || maxPoints == 0) return curve;
+    size_t points = std::min(samples.size(), maxPoints);
+    for (size_t p = 0; p < points; p++) {
+        size_t step = points > 1 ? p * (samples.size() - 1) / (points - 1) : 0;
+        curve.push_back(static_cast<float>(samples[step].sortedFraction()));
+    }
+    return curve;
+}
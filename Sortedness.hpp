@@ -0,0 +1,113 @@
+#pragma once
+
+#ifndef SORTEDNESS_HPP
+#define SORTEDNESS_HPP
+
+#include <vector>
+#include <set>
+#include <cstddef>
+#include <cstdint>
+
+struct SortednessMetrics {
+    size_t n = 0;
+    long long inversions = 0;     // pairs i < j with a[i] > a[j]
+    size_t longestRun = 0;        // longest non-decreasing stretch
+    size_t inPlace = 0;           // elements already equal to the sorted array there
+
+    long long maxInversions() const { return static_cast<long long>(n) * (n > 0 ? n - 1 : 0) / 2; }
+    // 1 when sorted, 0 when reversed
+    double sortedFraction() const {
+        return maxInversions() > 0 ? 1.0 - static_cast<double>(inversions) / maxInversions() : 1.0;
+    }
+};
+
+// Sortedness kept current one write at a time. Positions are split into
+// blocks, each with a Fenwick tree over value ranks, so the inversions a
+// write adds or removes are counted in O(n / B log n + B) rather than
+// recounted from scratch; runs are tracked through the set of descents.
+// Ranks come from the values present at reset(); writing a value outside
+// that multiset rebuilds everything (rebuilds() counts how often). A write
+// that duplicates a value already present keeps the ranks valid, but
+// inPlace is measured against the sorted values as of the last sync(), so
+// it is exact only while the array holds that multiset.
+class SortednessTracker {
+public:
+    void reset(const std::vector<int>& arr);
+    void write(size_t index, int value);
+    // If the writes since the last sync left a different multiset of
+    // values, re-sorts it from per-rank counts in O(n) and recounts inPlace.
+    // Meant for step boundaries: a swap passes through a duplicate on its way.
+    void sync();
+
+    const SortednessMetrics& metrics() const { return current; }
+    const std::vector<int>& values() const { return array; }
+    size_t rebuilds() const { return rebuildCount; }
+
+private:
+    int rankOf(int value) const;  // -1 if not in the reset-time multiset
+    int rankPrefix(size_t block, int rank) const;  // ranks < rank in block
+    void rankAdd(size_t block, int rank, int delta);
+    long long countRanks(size_t begin, size_t end, int lowRank, int highRank) const;
+    long long contribution(size_t index, int rank) const;
+    void setDescent(size_t index, bool descent);
+
+    std::vector<int> array;
+    std::vector<int> ranks;
+    std::vector<int> sorted;      // reset-time values; ranks index into it
+    std::vector<int> target;      // sorted values as of the last sync()
+    std::vector<int> targetCount; // per rank: occurrences in target
+    std::vector<int> balance;     // per rank: count now minus targetCount
+    size_t unbalanced = 0;        // ranks whose balance is not zero
+    size_t blockSize = 1;
+    std::vector<int> trees;       // one Fenwick tree of n + 1 counters per block
+    std::set<size_t> descents;    // i with a[i] > a[i + 1]
+    std::multiset<size_t> runs;   // lengths of the maximal non-decreasing runs
+    SortednessMetrics current;
+    size_t rebuildCount = 0;
+};
+
+// One run of a visual sort: the metrics after every step, and a log of the
+// writes between steps so the view can be moved back and forth without
+// re-running the sort. The log stops (and seeking with it) past
+// kMaxLoggedWrites; an array of another length starts a new history.
+class RunHistory {
+public:
+    static constexpr size_t kMaxLoggedWrites = size_t(1) << 23;
+
+    void begin(const int* values, size_t count);
+    void begin(const std::vector<int>& arr) { begin(arr.data(), arr.size()); }
+    // Appends a step; the callbacks hand over the whole array, so changed
+    // positions are found with one compare and applied as writes
+    void record(const int* values, size_t count);
+    void record(const std::vector<int>& arr) { record(arr.data(), arr.size()); }
+    void clear();
+
+    size_t steps() const { return samples.size(); }
+    size_t position() const { return shown; }
+    bool seekable() const { return logging; }
+    const SortednessMetrics& at(size_t step) const { return samples[step]; }
+    const SortednessMetrics& metrics() const { return tracker.metrics(); }
+    const std::vector<int>& array() const { return tracker.values(); }
+
+    // Undoes or replays logged writes up to `step`; returns the array there
+    const std::vector<int>& seek(size_t step);
+
+    // sortedFraction() over the run, at most maxPoints evenly spaced samples
+    std::vector<float> sortednessCurve(size_t maxPoints) const;
+
+private:
+    struct Write {
+        uint32_t index;
+        int before;
+        int after;
+    };
+
+    SortednessTracker tracker;
+    std::vector<SortednessMetrics> samples;
+    std::vector<Write> writes;
+    std::vector<size_t> stepEnd;   // writes[stepEnd[s - 1], stepEnd[s]) lead to step s
+    size_t shown = 0;
+    bool logging = true;
+};
+
+#endif // SORTEDNESS_HPP
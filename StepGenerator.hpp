@@ -0,0 +1,70 @@
+#pragma once
+
+#ifndef STEP_GENERATOR_HPP
+#define STEP_GENERATOR_HPP
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// Minimal C++20 generator: an algorithm written as a coroutine co_yields
+// one visual step at a time and only runs when the next step is asked for.
+template <typename T>
+class StepGenerator {
+public:
+    struct promise_type {
+        const T* current = nullptr;
+        std::exception_ptr exception;
+
+        StepGenerator get_return_object() {
+            return StepGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        // The yielded object stays alive in the suspended coroutine frame
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = &value;
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    StepGenerator() = default;
+    StepGenerator(const StepGenerator&) = delete;
+    StepGenerator& operator=(const StepGenerator&) = delete;
+    StepGenerator(StepGenerator&& other) noexcept : coro(std::exchange(other.coro, {})) {}
+    StepGenerator& operator=(StepGenerator&& other) noexcept {
+        if (this != &other) {
+            reset();
+            coro = std::exchange(other.coro, {});
+        }
+        return *this;
+    }
+    ~StepGenerator() { reset(); }
+
+    // Runs the algorithm up to its next step and returns it, or nullptr once
+    // it has finished. The step is only valid until the next call, so callers
+    // copy it into wherever they memoize steps.
+    const T* next() {
+        if (!coro || coro.done()) return nullptr;
+        coro.resume();
+        if (coro.promise().exception) std::rethrow_exception(coro.promise().exception);
+        if (coro.done()) return nullptr;
+        return coro.promise().current;
+    }
+
+    bool done() const { return !coro || coro.done(); }
+
+    void reset() {
+        if (coro) coro.destroy();
+        coro = {};
+    }
+
+private:
+    explicit StepGenerator(std::coroutine_handle<promise_type> handle) : coro(handle) {}
+
+    std::coroutine_handle<promise_type> coro;
+};
+
+#endif // STEP_GENERATOR_HPP
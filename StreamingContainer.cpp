@@ -0,0 +1,120 @@
+#include "StreamingContainer.hpp"
+#include "SortAlgorithms.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+
+SortedChunkStore::SortedChunkStore(size_t bufferCapacity)
+    : capacity(std::max<size_t>(bufferCapacity, 1)) {
+    pending.reserve(capacity);
+}
+
+void SortedChunkStore::insert(int value) {
+    compacted = false;
+    pending.push_back(value);
+    if (pending.size() >= capacity) flush();
+}
+
+void SortedChunkStore::flush() {
+    // Ingest is often nearly in order, which the natural merge sort exploits
+    naturalMergeSort(pending);
+    sortedRuns.push_back(pending);
+    pending.clear();
+    flushCount++;
+    compacted = true;
+    action = "Flushed buffer into run of " + std::to_string(sortedRuns.back().size());
+
+    while (sortedRuns.size() >= 2) {
+        std::vector<int>& older = sortedRuns[sortedRuns.size() - 2];
+        std::vector<int>& newer = sortedRuns.back();
+        if (older.size() > 2 * newer.size()) break;
+
+        scratch.resize(older.size() + newer.size());
+        std::merge(older.begin(), older.end(), newer.begin(), newer.end(), scratch.begin());
+        action += "\nCompacted runs of " + std::to_string(older.size()) + " and " +
+                  std::to_string(newer.size()) + " into " + std::to_string(scratch.size());
+        older.swap(scratch);
+        sortedRuns.pop_back();
+        mergeCount++;
+    }
+}
+
+size_t SortedChunkStore::countLess(int value) const {
+    size_t rank = 0;
+    for (const auto& run : sortedRuns) {
+        rank += std::lower_bound(run.begin(), run.end(), value) - run.begin();
+    }
+    for (int v : pending) rank += v < value;
+    return rank;
+}
+
+bool SortedChunkStore::contains(int value) const {
+    for (const auto& run : sortedRuns) {
+        if (std::binary_search(run.begin(), run.end(), value)) return true;
+    }
+    return std::find(pending.begin(), pending.end(), value) != pending.end();
+}
+
+size_t SortedChunkStore::size() const {
+    size_t total = pending.size();
+    for (const auto& run : sortedRuns) total += run.size();
+    return total;
+}
+
+void SortedChunkStore::clear() {
+    pending.clear();
+    sortedRuns.clear();
+    flushCount = 0;
+    mergeCount = 0;
+    action.clear();
+    compacted = false;
+}
+
+StreamSource::StreamSource() : gen(std::random_device{}()) {}
+
+bool StreamSource::openFile(const std::string& path) {
+    file.close();
+    file.clear();
+    file.open(path, std::ios::binary);
+    position = 0;
+    ready.clear();
+    skipped = 0;
+    return file.is_open();
+}
+
+bool StreamSource::next(int& value) {
+    if (!file.is_open()) {
+        std::uniform_int_distribution<> dist(1, 99);
+        value = dist(gen);
+        return true;
+    }
+
+    // Re-read from the end of the last complete line so a writer appending
+    // to the file is picked up on a later call. A final line without its
+    // newline is left for then, so a number caught mid-write is not split.
+    while (ready.empty()) {
+        file.clear();
+        file.seekg(position);
+        std::string line;
+        if (!std::getline(file, line) || file.eof()) return false;
+        position += static_cast<std::streamoff>(line.size()) + 1;
+
+        std::istringstream tokens(line);
+        std::string token;
+        while (tokens >> token) {
+            char* end = nullptr;
+            errno = 0;
+            long parsed = std::strtol(token.c_str(), &end, 10);
+            if (*end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+                skipped++;
+                continue;
+            }
+            ready.push_back(static_cast<int>(parsed));
+        }
+    }
+    value = ready.front();
+    ready.pop_front();
+    return true;
+}
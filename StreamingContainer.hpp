@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef STREAMING_CONTAINER_HPP
+#define STREAMING_CONTAINER_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+#include <deque>
+
+// Sorted-chunk LSM for values that arrive one at a time. Inserts land in a
+// small unsorted buffer; a full buffer is sorted into a run, and runs are
+// merged pairwise whenever the newer one grows to half the older one's size,
+// so there are O(log n) runs and each value is merged O(log n) times.
+class SortedChunkStore {
+public:
+    explicit SortedChunkStore(size_t bufferCapacity = 1024);
+
+    void insert(int value);
+    size_t countLess(int value) const;  // rank query over buffer and runs
+    bool contains(int value) const;
+    size_t size() const;
+    void clear();
+
+    const std::vector<int>& buffer() const { return pending; }
+    const std::vector<std::vector<int>>& runs() const { return sortedRuns; }
+    size_t flushes() const { return flushCount; }
+    size_t merges() const { return mergeCount; }
+    // Description of the last flush/compaction, for the explanation panel
+    const std::string& lastAction() const { return action; }
+    bool compactedOnLastInsert() const { return compacted; }
+
+private:
+    void flush();
+
+    size_t capacity;
+    std::vector<int> pending;
+    std::vector<std::vector<int>> sortedRuns;
+    std::vector<int> scratch;
+    size_t flushCount = 0;
+    size_t mergeCount = 0;
+    std::string action;
+    bool compacted = false;
+};
+
+// Where streamed values come from: a file that is tailed as it grows
+// (one integer per line), or random values when no file is open
+class StreamSource {
+public:
+    StreamSource();
+
+    bool openFile(const std::string& path);
+    bool isFile() const { return file.is_open(); }
+    // False when the tailed file has nothing new yet. Only newline-terminated
+    // lines are read, so a line still being written waits for its newline.
+    bool next(int& value);
+    // Tokens in the file that were not integers; they are skipped
+    size_t skippedTokens() const { return skipped; }
+
+private:
+    std::ifstream file;
+    std::streamoff position = 0;   // bytes of complete lines consumed
+    std::deque<int> ready;         // parsed values not handed out yet
+    size_t skipped = 0;
+    std::mt19937 gen;
+};
+
+#endif // STREAMING_CONTAINER_HPP
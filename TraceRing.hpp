@@ -0,0 +1,279 @@
+#pragma once
+
+#ifndef TRACE_RING_HPP
+#define TRACE_RING_HPP
+
+// Header-only transport for streaming sort steps from another process into
+// the visualizer. A producer owns a POSIX shared-memory ring of fixed-size
+// step events; the visualizer maps the same object and renders events in
+// place, releasing each slot only after it has been drawn.
+//
+// Producer side needs nothing but this header:
+//   trace::TraceProducer producer;
+//   if (producer.create()) producer.publish(arr.data(), arr.size(), i, j, "Swapped");
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TRACE_RING_POSIX 1
+#endif
+
+namespace trace {
+
+constexpr uint32_t kMagic = 0x53565452; // "SVTR"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kSlotCount = 1024;   // power of two
+constexpr uint32_t kMaxValues = 512;    // array plus count values per event
+constexpr uint32_t kTextSize = 160;
+constexpr const char* kDefaultRingName = "/sortvis-trace";
+
+enum class EventKind : uint32_t {
+    Array = 0,   // values[0, arrayLength) drawn with drawArray
+    Counting = 1, // array followed by countLength counts, drawn with drawCountingSort
+    Done = 2
+};
+
+struct Event {
+    EventKind kind;
+    int32_t highlighted;
+    int32_t secondary;
+    uint32_t arrayLength;
+    uint32_t countLength;
+    char text[kTextSize];
+    int32_t values[kMaxValues];
+
+    const int* array() const { return values; }
+    const int* counts() const { return values + arrayLength; }
+};
+
+struct RingHeader {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    std::atomic<uint64_t> writeIndex;
+    std::atomic<uint64_t> readIndex;
+    std::atomic<uint32_t> producerAlive;
+};
+
+struct Ring {
+    RingHeader header;
+    Event slots[kSlotCount];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring indexes must be lock-free across processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring flags must be lock-free across processes");
+
+namespace detail {
+
+inline Ring* mapRing(const std::string& name, bool create) {
+#ifdef TRACE_RING_POSIX
+    // The producer always starts a new object, so a consumer still mapping
+    // an older ring under this name keeps it rather than seeing its indexes
+    // reset underneath it
+    if (create) shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) return nullptr;
+    if (create && ftruncate(fd, sizeof(Ring)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    // Until the producer's ftruncate the object is empty, and touching a
+    // mapping past its end raises SIGBUS
+    struct stat st;
+    if (!create && (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Ring)))) {
+        close(fd);
+        return nullptr;
+    }
+    void* mem = mmap(nullptr, sizeof(Ring), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return mem == MAP_FAILED ? nullptr : static_cast<Ring*>(mem);
+#else
+    (void)name;
+    (void)create;
+    return nullptr;
+#endif
+}
+
+inline void unmapRing(Ring* ring) {
+#ifdef TRACE_RING_POSIX
+    if (ring) munmap(ring, sizeof(Ring));
+#else
+    (void)ring;
+#endif
+}
+
+} // namespace detail
+
+class TraceProducer {
+public:
+    TraceProducer() = default;
+    TraceProducer(const TraceProducer&) = delete;
+    TraceProducer& operator=(const TraceProducer&) = delete;
+    ~TraceProducer() { close(); }
+
+    // Creates the ring, replacing any ring left under `name` (a consumer
+    // attached to that one keeps it until it detaches). Returns false where
+    // POSIX shared memory is unavailable.
+    bool create(const std::string& name = kDefaultRingName) {
+        close();
+        ring = detail::mapRing(name, true);
+        if (!ring) return false;
+
+        RingHeader& h = ring->header;
+        h.magic.store(0, std::memory_order_relaxed);
+        h.version = kVersion;
+        h.slotCount = kSlotCount;
+        h.slotSize = sizeof(Event);
+        h.writeIndex.store(0, std::memory_order_relaxed);
+        h.readIndex.store(0, std::memory_order_relaxed);
+        h.producerAlive.store(1, std::memory_order_relaxed);
+        h.magic.store(kMagic, std::memory_order_release);
+        return true;
+    }
+
+    // When the consumer falls a full ring behind, either wait for it (the
+    // default, so no step is lost) or drop the event
+    void setBlockWhenFull(bool block) { blockWhenFull = block; }
+
+    bool publish(const int* array, size_t arrayLength, int highlighted, int secondary,
+                 const std::string& text) {
+        return write(EventKind::Array, array, arrayLength, nullptr, 0, highlighted, secondary, text);
+    }
+
+    bool publishCounting(const int* array, size_t arrayLength, const int* counts, size_t countLength,
+                         int highlighted, const std::string& text) {
+        return write(EventKind::Counting, array, arrayLength, counts, countLength, highlighted, -1, text);
+    }
+
+    bool finish(const std::string& text) {
+        return write(EventKind::Done, nullptr, 0, nullptr, 0, -1, -1, text);
+    }
+
+    // Waits until a consumer has read every published event, or the timeout
+    // passes; true when everything was read
+    bool waitUntilRead(std::chrono::milliseconds timeout) const {
+        if (!ring) return false;
+        const RingHeader& h = ring->header;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (h.readIndex.load(std::memory_order_acquire) != h.writeIndex.load(std::memory_order_relaxed)) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+
+    void close() {
+        if (!ring) return;
+        ring->header.producerAlive.store(0, std::memory_order_release);
+        detail::unmapRing(ring);
+        ring = nullptr;
+    }
+
+    // Removes the name from /dev/shm; a consumer that already mapped the
+    // ring keeps it until it detaches
+    static void unlink(const std::string& name = kDefaultRingName) {
+#ifdef TRACE_RING_POSIX
+        shm_unlink(name.c_str());
+#else
+        (void)name;
+#endif
+    }
+
+private:
+    bool write(EventKind kind, const int* array, size_t arrayLength, const int* counts,
+               size_t countLength, int highlighted, int secondary, const std::string& text) {
+        if (!ring) return false;
+        RingHeader& h = ring->header;
+
+        uint64_t w = h.writeIndex.load(std::memory_order_relaxed);
+        while (w - h.readIndex.load(std::memory_order_acquire) >= kSlotCount) {
+            if (!blockWhenFull) return false;
+            std::this_thread::yield();
+        }
+
+        Event& e = ring->slots[w & (kSlotCount - 1)];
+        arrayLength = std::min<size_t>(arrayLength, kMaxValues);
+        countLength = std::min<size_t>(countLength, kMaxValues - arrayLength);
+        e.kind = kind;
+        e.highlighted = highlighted;
+        e.secondary = secondary;
+        e.arrayLength = static_cast<uint32_t>(arrayLength);
+        e.countLength = static_cast<uint32_t>(countLength);
+        if (array && arrayLength) std::memcpy(e.values, array, arrayLength * sizeof(int32_t));
+        if (counts && countLength) std::memcpy(e.values + arrayLength, counts, countLength * sizeof(int32_t));
+        size_t textLength = std::min<size_t>(text.size(), kTextSize - 1);
+        std::memcpy(e.text, text.data(), textLength);
+        e.text[textLength] = '\0';
+
+        h.writeIndex.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    Ring* ring = nullptr;
+    bool blockWhenFull = true;
+};
+
+class TraceConsumer {
+public:
+    TraceConsumer() = default;
+    TraceConsumer(const TraceConsumer&) = delete;
+    TraceConsumer& operator=(const TraceConsumer&) = delete;
+    ~TraceConsumer() { detach(); }
+
+    bool attach(const std::string& name = kDefaultRingName) {
+        detach();
+        ring = detail::mapRing(name, false);
+        if (ring && (ring->header.magic.load(std::memory_order_acquire) != kMagic ||
+                     ring->header.version != kVersion || ring->header.slotSize != sizeof(Event))) {
+            detach();
+        }
+        return ring != nullptr;
+    }
+
+    bool attached() const { return ring != nullptr; }
+    bool producerAlive() const {
+        return ring && ring->header.producerAlive.load(std::memory_order_acquire) != 0;
+    }
+
+    // Oldest unread event, read in place; it stays valid until release()
+    const Event* peek() const {
+        if (!ring) return nullptr;
+        const RingHeader& h = ring->header;
+        uint64_t r = h.readIndex.load(std::memory_order_relaxed);
+        if (r == h.writeIndex.load(std::memory_order_acquire)) return nullptr;
+        return &ring->slots[r & (kSlotCount - 1)];
+    }
+
+    void release() {
+        if (!ring) return;
+        RingHeader& h = ring->header;
+        uint64_t r = h.readIndex.load(std::memory_order_relaxed);
+        if (r != h.writeIndex.load(std::memory_order_acquire)) {
+            h.readIndex.store(r + 1, std::memory_order_release);
+        }
+    }
+
+    void detach() {
+        detail::unmapRing(ring);
+        ring = nullptr;
+    }
+
+private:
+    Ring* ring = nullptr;
+};
+
+} // namespace trace
+
+#endif // TRACE_RING_HPP
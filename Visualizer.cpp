@@ -1,301 +1,902 @@
-#include "Visualizer.hpp"
-#include <SFML/Graphics.hpp>
-#include <iomanip>
-#include <sstream>
-#include <algorithm>
-#include <locale>
-#include <codecvt>
-#include <SFML/System/String.hpp>
-
-void drawArray(sf::RenderWindow& window, const std::vector<int>& array, 
-              int highlightIndex, int secondHighlight, const sf::Font& font) {
-    const float boxWidth = 50.f;
-    const float boxHeight = 50.f;
-    const float spacing = 10.f;
-    const float startX = 20.f;
-    const float yPos = 190.f;  // Increased from 100 to 150
-
-    for (size_t i = 0; i < array.size(); ++i) {
-        float x = startX + i * (boxWidth + spacing);
-
-        sf::RectangleShape box(sf::Vector2f(boxWidth, boxHeight));
-        box.setPosition(x, yPos);
-        
-        if (static_cast<int>(i) == highlightIndex) {
-            box.setFillColor(sf::Color::Yellow);
-        } 
-        else if (static_cast<int>(i) == secondHighlight) {
-            box.setFillColor(sf::Color::Cyan);
-        }
-        else {
-            box.setFillColor(sf::Color::White);
-        }
-
-        box.setOutlineColor(sf::Color::Black);
-        box.setOutlineThickness(2);
-        window.draw(box);
-
-        sf::Text text;
-        text.setFont(font);
-        text.setString(std::to_string(array[i]));
-        text.setCharacterSize(20);
-        text.setFillColor(sf::Color::Black);
-
-        sf::FloatRect bounds = text.getLocalBounds();
-        text.setOrigin(bounds.width / 2, bounds.height / 2);
-        text.setPosition(x + boxWidth / 2, yPos + boxHeight / 2);
-        window.draw(text);
-    }
-}
-void drawQuickSortVisualization(sf::RenderWindow& window, const QuickSortStep& step, 
-                              const VisualizerState& state, const SortStats& stats,
-                              const sf::Font& font) {
-    const float startX = 50.f;
-    const float startY = 100.f;
-    const float boxSize = 40.f;
-    const float spacing = 10.f;
-    const float verticalSpacing = 80.f;
-    const float infoSpacing = 30.f;
-
-    // Draw the main array
-    for (size_t i = 0; i < step.array.size(); ++i) {
-        sf::RectangleShape box(sf::Vector2f(boxSize, boxSize));
-        box.setPosition(startX + i * (boxSize + spacing), startY);
-        
-        // Color coding
-        if (i == step.pivotIndex) {
-            box.setFillColor(sf::Color::Red);
-        } 
-        else if (i == step.comparingIndex) {
-            box.setFillColor(sf::Color::Yellow);
-        }
-        else if (step.leftBound != -1 && i >= step.leftBound && i <= step.rightBound) {
-            box.setFillColor(sf::Color(200, 255, 200));
-        }
-        else {
-            box.setFillColor(sf::Color(220, 220, 220));
-        }
-
-        box.setOutlineColor(sf::Color::Black);
-        box.setOutlineThickness(2);
-        window.draw(box);
-
-        // Draw array value
-        sf::Text text;
-        text.setFont(font);
-        text.setString(std::to_string(step.array[i]));
-        text.setCharacterSize(20);
-        text.setFillColor(sf::Color::Black);
-
-        sf::FloatRect bounds = text.getLocalBounds();
-        text.setOrigin(bounds.width / 2, bounds.height / 2);
-        text.setPosition(box.getPosition().x + boxSize / 2, box.getPosition().y + boxSize / 2);
-        window.draw(text);
-    }
-
-    // Current step explanation
-    sf::Text stepText;
-    stepText.setFont(font);
-    stepText.setString(step.explanation);
-    stepText.setCharacterSize(20);
-    stepText.setFillColor(sf::Color::Black);
-    stepText.setPosition(startX, startY + verticalSpacing);
-    window.draw(stepText);
-
-    // Navigation instructions (always shown)
-    sf::Text instructions;
-    instructions.setFont(font);
-    instructions.setString("LEFT/RIGHT: Navigate | SPACE: Auto-play | R: Reset");
-    instructions.setCharacterSize(20);
-    instructions.setFillColor(sf::Color::Black);
-    instructions.setPosition(startX, window.getSize().y - 100);
-    window.draw(instructions);
-
-    // Step counter (always shown)
-    sf::Text stepCounter;
-    stepCounter.setFont(font);
-    stepCounter.setString("Step " + std::to_string(state.currentQuickStep + 1) +
-                        " of " + std::to_string(static_cast<int>(state.quickSortSteps.size())));
-    stepCounter.setCharacterSize(20);
-    stepCounter.setFillColor(sf::Color::Black);
-    stepCounter.setPosition(startX, window.getSize().y - 70);
-    window.draw(stepCounter);
-
-    // Completion message (only shown on final step)
-    if (state.currentQuickStep == static_cast<int>(state.quickSortSteps.size()) - 1) {
-        sf::Text completionText;
-        completionText.setFont(font);
-        completionText.setString("QuickSort Complete!\n" +
-                                std::to_string(stats.timeTaken) + "ms\n" +
-                               "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
-                               "Swaps: " + std::to_string(stats.swaps) + "\n" +
-                               "Time Complexity: O(n log n) avg, O(n²) worst\n" +
-                               "Space Complexity: O(log n)");
-        completionText.setCharacterSize(20);
-        completionText.setFillColor(sf::Color::Green);
-        completionText.setPosition(startX, startY + verticalSpacing + infoSpacing * 2);
-        window.draw(completionText);
-    }
-}
-void drawBuckets(sf::RenderWindow& window, const std::vector<std::vector<float>>& buckets,
-                const std::string& currentStep, const sf::Font& font) {
-    const float startX = 100.f;
-    const float startY = 110.f;  // Increased from 50 to 100
-    const float rectWidth = 60.f;
-    const float rectHeight = 30.f;
-    const float spacingX = 10.f;
-    const float spacingY = 60.f;  // Increased from 50 to 60
-
-    // Draw each bucket
-    for (size_t i = 0; i < buckets.size(); ++i) {
-        float y = startY + i * spacingY;
-
-        // Bucket label
-        sf::Text indexText;
-        indexText.setFont(font);
-        indexText.setString("Bucket " + std::to_string(i) + ":");
-        indexText.setCharacterSize(16);
-        indexText.setFillColor(sf::Color::Black);
-        indexText.setPosition(20, y);
-        window.draw(indexText);
-
-        // Bucket elements
-        for (size_t j = 0; j < buckets[i].size(); ++j) {
-            float x = startX + j * (rectWidth + spacingX);
-
-            sf::RectangleShape rect(sf::Vector2f(rectWidth, rectHeight));
-            rect.setPosition(x, y);
-            rect.setFillColor(sf::Color(100, 150, 250));
-            rect.setOutlineColor(sf::Color::Black);
-            rect.setOutlineThickness(1);
-            window.draw(rect);
-
-            // Value text
-            sf::Text text;
-            std::stringstream ss;
-            ss << std::fixed << std::setprecision(2) << buckets[i][j];
-            text.setFont(font);
-            text.setString(ss.str());
-            text.setCharacterSize(14);
-            text.setFillColor(sf::Color::Black);
-
-            sf::FloatRect bounds = text.getLocalBounds();
-            text.setOrigin(bounds.width / 2, bounds.height / 2);
-            text.setPosition(x + rectWidth / 2, y + rectHeight / 2);
-            window.draw(text);
-        }
-    }
-
-    drawExplanation(window, currentStep, font);
-}
-
-void drawCountingSort(sf::RenderWindow& window, const std::vector<int>& array,
-                    const std::vector<int>& countArray, int highlightedIndex,
-                    const sf::Font& font) {
-    const float windowWidth = window.getSize().x;
-    const float arrayStartY = 200.f;  // Increased from 100 to 150
-    const float countStartY = 300.f;  // Increased from 200 to 250
-    const float boxWidth = 50.f;
-    const float boxHeight = 50.f;
-    const float countBoxHeight = 30.f;
-    const float spacing = 10.f;
-    const float countSpacing = 5.f;
-    float startX = 20.f;
-
-    // Draw main array
-    for (size_t i = 0; i < array.size(); ++i) {
-        float x = startX + i * (boxWidth + spacing);
-        
-        sf::RectangleShape box(sf::Vector2f(boxWidth, boxHeight));
-        box.setPosition(x, arrayStartY);
-        box.setFillColor(static_cast<int>(i) == highlightedIndex ? sf::Color::Yellow : sf::Color::White);
-        box.setOutlineColor(sf::Color::Black);
-        box.setOutlineThickness(2);
-        window.draw(box);
-
-        sf::Text text;
-        text.setFont(font);
-        text.setString(std::to_string(array[i]));
-        text.setCharacterSize(20);
-        text.setFillColor(sf::Color::Black);
-        
-        sf::FloatRect bounds = text.getLocalBounds();
-        text.setOrigin(bounds.width / 2, bounds.height / 2);
-        text.setPosition(x + boxWidth / 2, arrayStartY + boxHeight / 2);
-        window.draw(text);
-    }
-
-    // Draw count array
-    const float maxBoxWidth = (windowWidth - 40.f) / countArray.size() - countSpacing;
-    const float countBoxWidth = std::min(30.f, maxBoxWidth);
-    
-    startX = 20.f;
-    for (size_t i = 0; i < countArray.size(); ++i) {
-        float x = startX + i * (countBoxWidth + countSpacing);
-        
-        if (x + countBoxWidth > windowWidth - 20.f) break;
-        
-        sf::RectangleShape box(sf::Vector2f(countBoxWidth, countBoxHeight));
-        box.setPosition(x, countStartY);
-        box.setFillColor(sf::Color(180, 220, 255));
-        box.setOutlineColor(sf::Color::Black);
-        box.setOutlineThickness(1);
-        window.draw(box);
-
-        sf::Text countText;
-        countText.setFont(font);
-        countText.setString(std::to_string(countArray[i]));
-        countText.setCharacterSize(16);
-        countText.setFillColor(sf::Color::Black);
-        
-        sf::FloatRect bounds = countText.getLocalBounds();
-        countText.setOrigin(bounds.width / 2, bounds.height / 2);
-        countText.setPosition(x + countBoxWidth / 2, countStartY + countBoxHeight / 2);
-        window.draw(countText);
-
-        if (countBoxWidth > 20.f) {
-            sf::Text indexText;
-            indexText.setFont(font);
-            indexText.setString(std::to_string(i));
-            indexText.setCharacterSize(14);
-            indexText.setFillColor(sf::Color::Black);
-            indexText.setPosition(x + countBoxWidth / 2, countStartY + countBoxHeight + 10);  // Increased from 5 to 10
-            window.draw(indexText);
-        }
-    }
-}
-
-void drawExplanation(sf::RenderWindow& window, const std::string& stepText, 
-                    const sf::Font& font) {
-    sf::Text explanation;
-    explanation.setFont(font);
-    explanation.setString(stepText);
-    explanation.setCharacterSize(20);
-    explanation.setFillColor(sf::Color::Black);
-    
-    // Wrap text if it's too long
-    float maxWidth = window.getSize().x - 80.f;
-    sf::FloatRect bounds = explanation.getLocalBounds();
-    if (bounds.width > maxWidth) {
-        std::string wrappedText;
-        std::string currentLine;
-        std::istringstream iss(stepText);
-        std::string word;
-        
-        while (iss >> word) {
-            sf::Text testText = explanation;
-            testText.setString(currentLine + word + " ");
-            if (testText.getLocalBounds().width < maxWidth) {
-                currentLine += word + " ";
-            } else {
-                wrappedText += currentLine + "\n";
-                currentLine = word + " ";
-            }
-        }
-        wrappedText += currentLine;
-        explanation.setString(wrappedText);
-    }
-    
-    explanation.setPosition(20.f, 20.f);
-    window.draw(explanation);
+#include "Visualizer.hpp"
+#include <SFML/Graphics.hpp>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <locale>
+#include <codecvt>
+#include <SFML/System/String.hpp>
+
+namespace {
+
+// Distinct pastels so the black value text stays readable on every thread
+sf::Color threadColor(int thread) {
+    static const sf::Color palette[] = {
+        sf::Color(144, 202, 249), sf::Color(165, 214, 167), sf::Color(255, 204, 128),
+        sf::Color(206, 147, 216), sf::Color(239, 154, 154), sf::Color(128, 222, 234),
+        sf::Color(230, 238, 156), sf::Color(188, 170, 164),
+    };
+    return palette[thread % (sizeof(palette) / sizeof(palette[0]))];
+}
+
+// The legend sits in the 30 pixels above the strip
+sf::FloatRect minimapArea(const sf::Vector2u& targetSize) {
+    return sf::FloatRect(20.f, 30.f, targetSize.x - 40.f, std::min(50.f, targetSize.y - 40.f));
+}
+
+// Distance between neighbouring boxes: the preferred pitch, or less when
+// `count` boxes would run past the right edge
+float boxPitch(const sf::Vector2u& targetSize, float startX, size_t count, float preferred) {
+    if (count == 0) return preferred;
+    return std::min(preferred, (targetSize.x - 2 * startX) / static_cast<float>(count));
+}
+
+// drawArray's row of boxes; arrayBoxesArea works out damage from the same numbers
+constexpr float kArrayStartX = 20.f;
+constexpr float kArrayTop = 190.f;
+constexpr float kArrayBoxHeight = 50.f;
+constexpr float kArrayPitch = 60.f;
+
+// Value text scaled down with its box; 0 once it would be unreadable
+unsigned valueTextSize(float boxWidth) {
+    unsigned size = static_cast<unsigned>(std::min(20.f, boxWidth * 0.4f));
+    return size >= 8 ? size : 0;
+}
+
+void drawCaption(sf::RenderTarget& window, const std::string& caption, float x, float y,
+                 const sf::Font& font) {
+    sf::Text text;
+    text.setFont(font);
+    text.setString(caption);
+    text.setCharacterSize(16);
+    text.setFillColor(sf::Color::Black);
+    text.setPosition(x, y);
+    window.draw(text);
+}
+
+// One cell per bin, shaded from white (empty) to dark blue (fullest bin)
+void drawDensityStrip(sf::RenderTarget& window, const BinnedHistogram& bins,
+                      float top, float height, const sf::Font& font) {
+    const float left = 20.f;
+    const float width = window.getSize().x - 40.f;
+    const long long fullest = bins.maxBin();
+    const float cellWidth = width / std::max<size_t>(1, bins.binCount());
+
+    sf::VertexArray cells(sf::Quads, bins.binCount() * 4);
+    long long total = 0;
+    for (size_t b = 0; b < bins.binCount(); ++b) {
+        total += bins.bin(b);
+        float level = fullest > 0 ? static_cast<float>(bins.bin(b)) / fullest : 0.f;
+        sf::Color color(static_cast<sf::Uint8>(255 - 215 * level),
+                        static_cast<sf::Uint8>(255 - 175 * level),
+                        static_cast<sf::Uint8>(255 - 55 * level));
+        float x = left + b * cellWidth;
+        cells[b * 4 + 0] = sf::Vertex(sf::Vector2f(x, top), color);
+        cells[b * 4 + 1] = sf::Vertex(sf::Vector2f(x + cellWidth, top), color);
+        cells[b * 4 + 2] = sf::Vertex(sf::Vector2f(x + cellWidth, top + height), color);
+        cells[b * 4 + 3] = sf::Vertex(sf::Vector2f(x, top + height), color);
+    }
+    window.draw(cells);
+
+    sf::RectangleShape frame(sf::Vector2f(width, height));
+    frame.setPosition(left, top);
+    frame.setFillColor(sf::Color::Transparent);
+    frame.setOutlineColor(sf::Color::Black);
+    frame.setOutlineThickness(1);
+    window.draw(frame);
+
+    drawCaption(window, std::to_string(bins.valueCount()) + " buckets, " +
+                        std::to_string(bins.binWidth()) + " per cell | " +
+                        std::to_string(total) + " elements placed | fullest cell: " +
+                        std::to_string(fullest),
+                left, top + height + 8.f, font);
+}
+
+// One bar per bin, scaled to the tallest bin
+void drawBinnedBars(sf::RenderTarget& window, const BinnedHistogram& bins,
+                    float top, float height, const sf::Font& font) {
+    const float left = 20.f;
+    const float width = window.getSize().x - 40.f;
+    const long long tallest = bins.maxBin();
+    const float barWidth = width / std::max<size_t>(1, bins.binCount());
+    const sf::Color barColor(180, 220, 255);
+
+    sf::VertexArray bars(sf::Quads, bins.binCount() * 4);
+    for (size_t b = 0; b < bins.binCount(); ++b) {
+        float barHeight = tallest > 0 ? height * bins.bin(b) / tallest : 0.f;
+        float x = left + b * barWidth;
+        float y = top + height - barHeight;
+        bars[b * 4 + 0] = sf::Vertex(sf::Vector2f(x, y), barColor);
+        bars[b * 4 + 1] = sf::Vertex(sf::Vector2f(x + barWidth, y), barColor);
+        bars[b * 4 + 2] = sf::Vertex(sf::Vector2f(x + barWidth, top + height), barColor);
+        bars[b * 4 + 3] = sf::Vertex(sf::Vector2f(x, top + height), barColor);
+    }
+    window.draw(bars);
+
+    sf::RectangleShape axis(sf::Vector2f(width, 1.f));
+    axis.setPosition(left, top + height);
+    axis.setFillColor(sf::Color::Black);
+    window.draw(axis);
+
+    drawCaption(window, std::to_string(bins.valueCount()) + " counts, " +
+                        std::to_string(bins.binWidth()) + " per bar | tallest bar: " +
+                        std::to_string(tallest),
+                left, top + height + 8.f, font);
+}
+
+// Element values as bars, one per pixel column, each sampled from its
+// column's index range; the column holding highlightedIndex is marked
+void drawSampledArray(sf::RenderTarget& window, const int* array, size_t size,
+                      int highlightedIndex, float top, float height) {
+    const float left = 20.f;
+    const size_t columns = std::min(size, static_cast<size_t>(window.getSize().x - 40.f));
+    const float columnWidth = (window.getSize().x - 40.f) / columns;
+    int largest = 1;
+    for (size_t c = 0; c < columns; ++c) largest = std::max(largest, array[c * size / columns]);
+
+    sf::VertexArray bars(sf::Quads, columns * 4);
+    for (size_t c = 0; c < columns; ++c) {
+        size_t first = c * size / columns;
+        size_t last = std::max((c + 1) * size / columns, first + 1);
+        bool highlighted = highlightedIndex >= 0 && static_cast<size_t>(highlightedIndex) >= first &&
+                           static_cast<size_t>(highlightedIndex) < last;
+        sf::Color color = highlighted ? sf::Color(230, 180, 0) : sf::Color(120, 120, 120);
+        float barHeight = height * std::max(array[first], 0) / largest;
+        float x = left + c * columnWidth;
+        float y = top + height - barHeight;
+        bars[c * 4 + 0] = sf::Vertex(sf::Vector2f(x, y), color);
+        bars[c * 4 + 1] = sf::Vertex(sf::Vector2f(x + columnWidth, y), color);
+        bars[c * 4 + 2] = sf::Vertex(sf::Vector2f(x + columnWidth, top + height), color);
+        bars[c * 4 + 3] = sf::Vertex(sf::Vector2f(x, top + height), color);
+    }
+    window.draw(bars);
+}
+
+} // namespace
+
+void drawArray(sf::RenderTarget& window, const std::vector<int>& array, 
+              int highlightIndex, int secondHighlight, const sf::Font& font,
+              const std::vector<int>& runBoundaries, bool galloping,
+              const std::vector<bool>& discarded, const std::vector<int>& threadOf) {
+    drawArray(window, array.data(), array.size(), highlightIndex, secondHighlight, font,
+              runBoundaries, galloping, discarded, threadOf);
+}
+
+void drawArray(sf::RenderTarget& window, const int* array, size_t size,
+              int highlightIndex, int secondHighlight, const sf::Font& font,
+              const std::vector<int>& runBoundaries, bool galloping,
+              const std::vector<bool>& discarded, const std::vector<int>& threadOf) {
+    const float startX = kArrayStartX;
+    const float pitch = boxPitch(window.getSize(), startX, size, kArrayPitch);
+    const float boxWidth = pitch * 5.f / 6.f;
+    const float boxHeight = kArrayBoxHeight;
+    const float spacing = pitch - boxWidth;
+    const float yPos = kArrayTop;
+    const unsigned textSize = valueTextSize(boxWidth);
+
+    for (size_t i = 0; i < size; ++i) {
+        float x = startX + i * (boxWidth + spacing);
+
+        sf::RectangleShape box(sf::Vector2f(boxWidth, boxHeight));
+        box.setPosition(x, yPos);
+        
+        if (static_cast<int>(i) == highlightIndex) {
+            box.setFillColor(galloping ? sf::Color::Magenta : sf::Color::Yellow);
+        } 
+        else if (static_cast<int>(i) == secondHighlight) {
+            box.setFillColor(sf::Color::Cyan);
+        }
+        else if (i < discarded.size() && discarded[i]) {
+            box.setFillColor(sf::Color(170, 170, 170));
+        }
+        else if (i < threadOf.size() && threadOf[i] >= 0) {
+            box.setFillColor(threadColor(threadOf[i]));
+        }
+        else {
+            box.setFillColor(sf::Color::White);
+        }
+
+        box.setOutlineColor(sf::Color::Black);
+        box.setOutlineThickness(spacing >= 4.f ? 2.f : 1.f);
+        window.draw(box);
+        if (textSize == 0) continue;
+
+        sf::Text text;
+        text.setFont(font);
+        text.setString(std::to_string(array[i]));
+        text.setCharacterSize(textSize);
+        text.setFillColor(i < discarded.size() && discarded[i] ? sf::Color(100, 100, 100) : sf::Color::Black);
+
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin(bounds.width / 2, bounds.height / 2);
+        text.setPosition(x + boxWidth / 2, yPos + boxHeight / 2);
+        window.draw(text);
+    }
+
+    // Run boundaries as red bars in the gap before the run's first element
+    for (int boundary : runBoundaries) {
+        if (boundary <= 0 || boundary >= static_cast<int>(size)) continue;
+        sf::RectangleShape bar(sf::Vector2f(4.f, boxHeight + 30.f));
+        bar.setPosition(startX + boundary * pitch - spacing / 2 - 2.f, yPos - 15.f);
+        bar.setFillColor(sf::Color::Red);
+        window.draw(bar);
+    }
+
+    // Legend for the thread colours, in the row the GALLOPING label uses
+    int threadCount = threadOf.empty() ? 0 : *std::max_element(threadOf.begin(), threadOf.end()) + 1;
+    for (int t = 0; t < threadCount; t++) {
+        float x = startX + t * 110.f;
+        sf::RectangleShape swatch(sf::Vector2f(20.f, 20.f));
+        swatch.setPosition(x, yPos + boxHeight + 28.f);
+        swatch.setFillColor(threadColor(t));
+        swatch.setOutlineColor(sf::Color::Black);
+        swatch.setOutlineThickness(1);
+        window.draw(swatch);
+        drawCaption(window, "Thread " + std::to_string(t), x + 26.f, yPos + boxHeight + 28.f, font);
+    }
+
+    if (galloping) {
+        sf::Text gallopText;
+        gallopText.setFont(font);
+        gallopText.setString("GALLOPING");
+        gallopText.setCharacterSize(20);
+        gallopText.setFillColor(sf::Color::Magenta);
+        gallopText.setPosition(startX, yPos + boxHeight + 25.f);
+        window.draw(gallopText);
+    }
+}
+
+sf::FloatRect arrayBoxesArea(const sf::Vector2u& targetSize, size_t size, int first, int last) {
+    if (size == 0 || last < first) return sf::FloatRect();
+    const float pitch = boxPitch(targetSize, kArrayStartX, size, kArrayPitch);
+    const float outline = 2.f;
+    const float left = kArrayStartX + first * pitch - outline;
+    const float right = kArrayStartX + last * pitch + pitch * 5.f / 6.f + outline;
+    return sf::FloatRect(left, kArrayTop - outline, right - left, kArrayBoxHeight + 2 * outline);
+}
+
+void drawHeapTree(sf::RenderTarget& window, const std::vector<int>& array, int heapSize,
+                  int arity, int highlightedIndex, int secondaryIndex, const sf::Font& font) {
+    heapSize = std::min(heapSize, static_cast<int>(array.size()));
+    if (heapSize <= 0 || arity < 2) return;
+
+    const float top = 300.f;
+    const float left = 20.f;
+    const float width = window.getSize().x - 2 * left;
+    int levels = 0;
+    for (long long covered = 0, levelSize = 1; covered < heapSize; covered += levelSize, levelSize *= arity) levels++;
+    const float levelGap = std::min(70.f, 150.f / levels);
+
+    // Node i sits at (level, position within level); parents are centred
+    // over their `arity` child slots
+    std::vector<sf::Vector2f> centres(heapSize);
+    std::vector<float> radii(heapSize);
+    long long levelStart = 0;
+    long long levelSize = 1;
+    for (int level = 0; level < levels; level++) {
+        float slot = width / static_cast<float>(levelSize);
+        for (long long p = 0; p < levelSize && levelStart + p < heapSize; p++) {
+            centres[levelStart + p] = sf::Vector2f(left + (p + 0.5f) * slot, top + level * levelGap + 20.f);
+            radii[levelStart + p] = std::min(18.f, slot * 0.45f);
+        }
+        levelStart += levelSize;
+        levelSize *= arity;
+    }
+
+    sf::VertexArray edges(sf::Lines);
+    for (int i = 1; i < heapSize; i++) {
+        edges.append(sf::Vertex(centres[(i - 1) / arity], sf::Color(90, 90, 90)));
+        edges.append(sf::Vertex(centres[i], sf::Color(90, 90, 90)));
+    }
+    window.draw(edges);
+
+    for (int i = 0; i < heapSize; i++) {
+        float radius = radii[i];
+        sf::CircleShape node(radius);
+        node.setOrigin(radius, radius);
+        node.setPosition(centres[i].x, centres[i].y);
+        if (i == highlightedIndex) node.setFillColor(sf::Color::Yellow);
+        else if (i == secondaryIndex) node.setFillColor(sf::Color::Cyan);
+        else node.setFillColor(sf::Color::White);
+        node.setOutlineColor(sf::Color::Black);
+        node.setOutlineThickness(2);
+        window.draw(node);
+
+        // Values stop fitting once the slots get narrow; colour alone still shows the path
+        if (radius < 10.f) continue;
+        sf::Text text;
+        text.setFont(font);
+        text.setString(std::to_string(array[i]));
+        text.setCharacterSize(16);
+        text.setFillColor(sf::Color::Black);
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin(bounds.width / 2, bounds.height / 2);
+        text.setPosition(centres[i].x, centres[i].y);
+        window.draw(text);
+    }
+}
+
+void drawQuickSortVisualization(sf::RenderTarget& window, const QuickSortStep& step, 
+                              const VisualizerState& state, const SortStats& stats,
+                              const sf::Font& font) {
+    const float startX = 50.f;
+    const float startY = 100.f;
+    const float pitch = boxPitch(window.getSize(), startX, step.array.size(), 50.f);
+    const float boxSize = pitch * 4.f / 5.f;
+    const float spacing = pitch - boxSize;
+    const float verticalSpacing = 80.f;
+    const unsigned textSize = valueTextSize(boxSize);
+    const float infoSpacing = 30.f;
+
+    // Draw the main array
+    for (size_t i = 0; i < step.array.size(); ++i) {
+        sf::RectangleShape box(sf::Vector2f(boxSize, boxSize));
+        box.setPosition(startX + i * (boxSize + spacing), startY);
+        
+        // Color coding
+        if (i == step.pivotIndex) {
+            box.setFillColor(sf::Color::Red);
+        } 
+        else if (i == step.comparingIndex) {
+            box.setFillColor(sf::Color::Yellow);
+        }
+        else if (step.leftBound != -1 && i >= step.leftBound && i <= step.rightBound) {
+            box.setFillColor(sf::Color(200, 255, 200));
+        }
+        else {
+            box.setFillColor(sf::Color(220, 220, 220));
+        }
+
+        box.setOutlineColor(sf::Color::Black);
+        box.setOutlineThickness(spacing >= 4.f ? 2.f : 1.f);
+        window.draw(box);
+        if (textSize == 0) continue;
+
+        // Draw array value
+        sf::Text text;
+        text.setFont(font);
+        text.setString(std::to_string(step.array[i]));
+        text.setCharacterSize(textSize);
+        text.setFillColor(sf::Color::Black);
+
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin(bounds.width / 2, bounds.height / 2);
+        text.setPosition(box.getPosition().x + boxSize / 2, box.getPosition().y + boxSize / 2);
+        window.draw(text);
+    }
+
+    // Current step explanation
+    sf::Text stepText;
+    stepText.setFont(font);
+    stepText.setString(step.explanation.c_str());
+    stepText.setCharacterSize(20);
+    stepText.setFillColor(sf::Color::Black);
+    stepText.setPosition(startX, startY + verticalSpacing);
+    window.draw(stepText);
+
+    // Navigation instructions (always shown)
+    sf::Text instructions;
+    instructions.setFont(font);
+    instructions.setString("LEFT/RIGHT: Navigate | SPACE: Auto-play | R: Reset");
+    instructions.setCharacterSize(20);
+    instructions.setFillColor(sf::Color::Black);
+    instructions.setPosition(startX, window.getSize().y - 100);
+    window.draw(instructions);
+
+    // Step counter (always shown)
+    sf::Text stepCounter;
+    stepCounter.setFont(font);
+    stepCounter.setString("Step " + std::to_string(state.currentQuickStep + 1) +
+                        " of " + std::to_string(static_cast<int>(state.quickSortSteps.size())));
+    stepCounter.setCharacterSize(20);
+    stepCounter.setFillColor(sf::Color::Black);
+    stepCounter.setPosition(startX, window.getSize().y - 70);
+    window.draw(stepCounter);
+
+    // Completion message (only shown on final step)
+    if (state.currentQuickStep == static_cast<int>(state.quickSortSteps.size()) - 1) {
+        sf::Text completionText;
+        completionText.setFont(font);
+        completionText.setString("QuickSort Complete!\n" +
+                                std::to_string(stats.timeTaken) + "ms\n" +
+                               "Comparisons: " + std::to_string(stats.comparisons) + "\n" +
+                               "Swaps: " + std::to_string(stats.swaps) + "\n" +
+                               "Time Complexity: O(n log n) avg, O(n²) worst\n" +
+                               "Space Complexity: O(log n)");
+        completionText.setCharacterSize(20);
+        completionText.setFillColor(sf::Color::Green);
+        completionText.setPosition(startX, startY + verticalSpacing + infoSpacing * 2);
+        window.draw(completionText);
+    }
+}
+void drawBuckets(sf::RenderTarget& window, const BucketList& buckets, const sf::Font& font,
+                const BinnedHistogram* fill) {
+    const float startX = 100.f;
+    const float startY = 110.f;  // Increased from 50 to 100
+    const float rectWidth = 60.f;
+    const float rectHeight = 30.f;
+    const float spacingX = 10.f;
+    const float spacingY = 60.f;  // Increased from 50 to 60
+
+    // More buckets than rows on screen: show fill levels as a density strip
+    if (startY + buckets.size() * spacingY > window.getSize().y) {
+        BinnedHistogram rebuilt;
+        if (!fill || fill->valueCount() != buckets.size()) {
+            rebuilt.reset(buckets.size());
+            for (size_t i = 0; i < buckets.size(); ++i) rebuilt.add(i, buckets[i].size());
+            fill = &rebuilt;
+        }
+        drawDensityStrip(window, *fill, startY, 60.f, font);
+        return;
+    }
+
+    // Draw each bucket
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        float y = startY + i * spacingY;
+
+        // Bucket label
+        sf::Text indexText;
+        indexText.setFont(font);
+        indexText.setString("Bucket " + std::to_string(i) + ":");
+        indexText.setCharacterSize(16);
+        indexText.setFillColor(sf::Color::Black);
+        indexText.setPosition(20, y);
+        window.draw(indexText);
+
+        // Bucket elements
+        for (size_t j = 0; j < buckets[i].size(); ++j) {
+            float x = startX + j * (rectWidth + spacingX);
+
+            sf::RectangleShape rect(sf::Vector2f(rectWidth, rectHeight));
+            rect.setPosition(x, y);
+            rect.setFillColor(sf::Color(100, 150, 250));
+            rect.setOutlineColor(sf::Color::Black);
+            rect.setOutlineThickness(1);
+            window.draw(rect);
+
+            // Value text
+            sf::Text text;
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2) << buckets[i][j];
+            text.setFont(font);
+            text.setString(ss.str());
+            text.setCharacterSize(14);
+            text.setFillColor(sf::Color::Black);
+
+            sf::FloatRect bounds = text.getLocalBounds();
+            text.setOrigin(bounds.width / 2, bounds.height / 2);
+            text.setPosition(x + rectWidth / 2, y + rectHeight / 2);
+            window.draw(text);
+        }
+    }
+}
+
+void drawCountingSort(sf::RenderTarget& window, const std::vector<int>& array,
+                    const std::vector<int>& countArray, int highlightedIndex,
+                    const sf::Font& font, const BinnedHistogram* countBins) {
+    drawCountingSort(window, array.data(), array.size(), countArray.data(), countArray.size(),
+                     highlightedIndex, font, countBins);
+}
+
+void drawCountingSort(sf::RenderTarget& window, const int* array, size_t arraySize,
+                    const int* countArray, size_t countSize, int highlightedIndex,
+                    const sf::Font& font, const BinnedHistogram* countBins) {
+    const float windowWidth = window.getSize().x;
+    const float arrayStartY = 200.f;  // Increased from 100 to 150
+    const float countStartY = 300.f;  // Increased from 200 to 250
+    const float boxWidth = 50.f;
+    const float boxHeight = 50.f;
+    const float countBoxHeight = 30.f;
+    const float spacing = 10.f;
+    const float countSpacing = 5.f;
+    float startX = 20.f;
+
+    // Too many elements for boxes: one sampled bar per pixel column instead
+    const bool sampleArray = startX + arraySize * (boxWidth + spacing) > windowWidth - 20.f;
+    if (sampleArray) {
+        drawSampledArray(window, array, arraySize, highlightedIndex, arrayStartY, boxHeight);
+    }
+
+    // Draw main array
+    for (size_t i = 0; !sampleArray && i < arraySize; ++i) {
+        float x = startX + i * (boxWidth + spacing);
+        
+        sf::RectangleShape box(sf::Vector2f(boxWidth, boxHeight));
+        box.setPosition(x, arrayStartY);
+        box.setFillColor(static_cast<int>(i) == highlightedIndex ? sf::Color::Yellow : sf::Color::White);
+        box.setOutlineColor(sf::Color::Black);
+        box.setOutlineThickness(2);
+        window.draw(box);
+
+        sf::Text text;
+        text.setFont(font);
+        text.setString(std::to_string(array[i]));
+        text.setCharacterSize(20);
+        text.setFillColor(sf::Color::Black);
+        
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin(bounds.width / 2, bounds.height / 2);
+        text.setPosition(x + boxWidth / 2, arrayStartY + boxHeight / 2);
+        window.draw(text);
+    }
+
+    // Draw count array
+    const float maxBoxWidth = (windowWidth - 40.f) / countSize - countSpacing;
+    const float countBoxWidth = std::min(30.f, maxBoxWidth);
+
+    // Boxes too narrow to read: binned bar chart of the counts instead
+    if (countBoxWidth < 12.f) {
+        BinnedHistogram rebuilt;
+        if (!countBins || countBins->valueCount() != countSize) {
+            rebuilt.assign(countArray, countSize);
+            countBins = &rebuilt;
+        }
+        drawBinnedBars(window, *countBins, countStartY, window.getSize().y - countStartY - 60.f, font);
+        return;
+    }
+    
+    startX = 20.f;
+    for (size_t i = 0; i < countSize; ++i) {
+        float x = startX + i * (countBoxWidth + countSpacing);
+        
+        if (x + countBoxWidth > windowWidth - 20.f) break;
+        
+        sf::RectangleShape box(sf::Vector2f(countBoxWidth, countBoxHeight));
+        box.setPosition(x, countStartY);
+        box.setFillColor(sf::Color(180, 220, 255));
+        box.setOutlineColor(sf::Color::Black);
+        box.setOutlineThickness(1);
+        window.draw(box);
+
+        sf::Text countText;
+        countText.setFont(font);
+        countText.setString(std::to_string(countArray[i]));
+        countText.setCharacterSize(16);
+        countText.setFillColor(sf::Color::Black);
+        
+        sf::FloatRect bounds = countText.getLocalBounds();
+        countText.setOrigin(bounds.width / 2, bounds.height / 2);
+        countText.setPosition(x + countBoxWidth / 2, countStartY + countBoxHeight / 2);
+        window.draw(countText);
+
+        if (countBoxWidth > 20.f) {
+            sf::Text indexText;
+            indexText.setFont(font);
+            indexText.setString(std::to_string(i));
+            indexText.setCharacterSize(14);
+            indexText.setFillColor(sf::Color::Black);
+            indexText.setPosition(x + countBoxWidth / 2, countStartY + countBoxHeight + 10);  // Increased from 5 to 10
+            window.draw(indexText);
+        }
+    }
+}
+
+void drawStringArray(sf::RenderTarget& window, const std::vector<std::string>& strings,
+                    int rangeStart, int rangeEnd, int depth, const sf::Font& font) {
+    const float boxWidth = 100.f;
+    const float boxHeight = 50.f;
+    const float spacing = 10.f;
+    const float startX = 20.f;
+    const float yPos = 190.f;
+
+    for (size_t i = 0; i < strings.size(); ++i) {
+        float x = startX + i * (boxWidth + spacing);
+        bool inRange = rangeStart != -1 && static_cast<int>(i) >= rangeStart &&
+                       static_cast<int>(i) <= rangeEnd;
+
+        sf::RectangleShape box(sf::Vector2f(boxWidth, boxHeight));
+        box.setPosition(x, yPos);
+        box.setFillColor(inRange ? sf::Color(200, 255, 200) : sf::Color::White);
+        box.setOutlineColor(sf::Color::Black);
+        box.setOutlineThickness(2);
+        window.draw(box);
+
+        sf::Text text;
+        text.setFont(font);
+        text.setString(strings[i]);
+        text.setCharacterSize(16);
+        text.setFillColor(sf::Color::Black);
+
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin(bounds.width / 2, bounds.height / 2);
+        text.setPosition(x + boxWidth / 2, yPos + boxHeight / 2);
+        window.draw(text);
+
+        // Character currently being examined (or $ once the string has ended)
+        if (depth >= 0) {
+            sf::Text charText;
+            charText.setFont(font);
+            charText.setString(depth < static_cast<int>(strings[i].size())
+                               ? std::string(1, strings[i][depth]) : std::string("$"));
+            charText.setCharacterSize(20);
+            charText.setFillColor(inRange ? sf::Color::Red : sf::Color(120, 120, 120));
+            charText.setPosition(x + boxWidth / 2 - 5.f, yPos + boxHeight + 10.f);
+            window.draw(charText);
+        }
+    }
+
+    if (depth >= 0) {
+        sf::Text depthText;
+        depthText.setFont(font);
+        depthText.setString("Character depth: " + std::to_string(depth));
+        depthText.setCharacterSize(20);
+        depthText.setFillColor(sf::Color::Black);
+        depthText.setPosition(startX, yPos + boxHeight + 50.f);
+        window.draw(depthText);
+    }
+}
+
+void drawSortedRuns(sf::RenderTarget& window, const std::vector<int>& buffer,
+                   const std::vector<std::vector<int>>& runs, bool highlightNewest,
+                   const sf::Font& font) {
+    const float startX = 120.f;
+    const float startY = 190.f;
+    const float rectHeight = 30.f;
+    const float spacingY = 60.f;
+    const float spacingX = 4.f;
+    const float maxWidth = window.getSize().x - startX - 20.f;
+
+    auto drawRow = [&](const std::vector<int>& values, float y, const std::string& label,
+                       sf::Color fill) {
+        sf::Text labelText;
+        labelText.setFont(font);
+        labelText.setString(label);
+        labelText.setCharacterSize(16);
+        labelText.setFillColor(sf::Color::Black);
+        labelText.setPosition(20, y);
+        window.draw(labelText);
+
+        // Shrink boxes so a whole run always fits on one row
+        float rectWidth = std::min(50.f, maxWidth / std::max<size_t>(values.size(), 1) - spacingX);
+        for (size_t j = 0; j < values.size(); ++j) {
+            float x = startX + j * (rectWidth + spacingX);
+
+            sf::RectangleShape rect(sf::Vector2f(rectWidth, rectHeight));
+            rect.setPosition(x, y);
+            rect.setFillColor(fill);
+            rect.setOutlineColor(sf::Color::Black);
+            rect.setOutlineThickness(1);
+            window.draw(rect);
+
+            if (rectWidth >= 20.f) {
+                sf::Text text;
+                text.setFont(font);
+                text.setString(std::to_string(values[j]));
+                text.setCharacterSize(14);
+                text.setFillColor(sf::Color::Black);
+
+                sf::FloatRect bounds = text.getLocalBounds();
+                text.setOrigin(bounds.width / 2, bounds.height / 2);
+                text.setPosition(x + rectWidth / 2, y + rectHeight / 2);
+                window.draw(text);
+            }
+        }
+    };
+
+    drawRow(buffer, startY, "Buffer:", sf::Color(255, 230, 150));
+    for (size_t i = 0; i < runs.size(); ++i) {
+        bool newest = highlightNewest && i + 1 == runs.size();
+        drawRow(runs[i], startY + (i + 1) * spacingY, "Run " + std::to_string(i) + ":",
+                newest ? sf::Color(150, 230, 150) : sf::Color(100, 150, 250));
+    }
+}
+
+void drawExplanation(sf::RenderTarget& window, const std::string& stepText, 
+                    const sf::Font& font) {
+    sf::Text explanation;
+    explanation.setFont(font);
+    explanation.setString(stepText);
+    explanation.setCharacterSize(20);
+    explanation.setFillColor(sf::Color::Black);
+    
+    // Wrap text if it's too long
+    float maxWidth = window.getSize().x - 80.f;
+    sf::FloatRect bounds = explanation.getLocalBounds();
+    if (bounds.width > maxWidth) {
+        std::string wrappedText;
+        std::string currentLine;
+        std::istringstream iss(stepText);
+        std::string word;
+        
+        while (iss >> word) {
+            sf::Text testText = explanation;
+            testText.setString(currentLine + word + " ");
+            if (testText.getLocalBounds().width < maxWidth) {
+                currentLine += word + " ";
+            } else {
+                wrappedText += currentLine + "\n";
+                currentLine = word + " ";
+            }
+        }
+        wrappedText += currentLine;
+        explanation.setString(wrappedText);
+    }
+    
+    explanation.setPosition(20.f, 20.f);
+    window.draw(explanation);
+}
+
+void drawProgressMinimap(sf::RenderTarget& window, const RunHistory& history, const sf::Font& font,
+                         const std::vector<float>& previousRun) {
+    const size_t steps = history.steps();
+    if (steps < 2) return;
+    const sf::FloatRect area = minimapArea(window.getSize());
+
+    sf::RectangleShape frame(sf::Vector2f(area.width, area.height));
+    frame.setPosition(area.left, area.top);
+    frame.setFillColor(sf::Color::White);
+    frame.setOutlineColor(sf::Color::Black);
+    frame.setOutlineThickness(1);
+    window.draw(frame);
+
+    // One point per pixel column at most, each the step at the column's start
+    auto plot = [&](size_t points, const std::function<float(size_t)>& valueAt, sf::Color color) {
+        if (points < 2) return;
+        sf::VertexArray line(sf::LineStrip, points);
+        for (size_t p = 0; p < points; ++p) {
+            float x = area.left + area.width * p / (points - 1);
+            float y = area.top + area.height * (1.f - std::clamp(valueAt(p), 0.f, 1.f));
+            line[p] = sf::Vertex(sf::Vector2f(x, y), color);
+        }
+        window.draw(line);
+    };
+    const size_t points = std::min(steps, static_cast<size_t>(area.width));
+    auto sample = [&](size_t p) -> const SortednessMetrics& { return history.at(p * (steps - 1) / (points - 1)); };
+    auto fraction = [](size_t part, size_t whole) { return whole > 0 ? static_cast<float>(part) / whole : 1.f; };
+
+    const sf::Color sortedColor(30, 90, 200), runColor(40, 150, 60), placeColor(230, 130, 0);
+    plot(previousRun.size(), [&](size_t p) { return previousRun[p]; }, sf::Color(170, 170, 170));
+    plot(points, [&](size_t p) { return fraction(sample(p).inPlace, sample(p).n); }, placeColor);
+    plot(points, [&](size_t p) { return fraction(sample(p).longestRun, sample(p).n); }, runColor);
+    plot(points, [&](size_t p) { return static_cast<float>(sample(p).sortedFraction()); }, sortedColor);
+
+    sf::RectangleShape marker(sf::Vector2f(2.f, area.height));
+    marker.setPosition(area.left + area.width * history.position() / (steps - 1) - 1.f, area.top);
+    marker.setFillColor(sf::Color::Red);
+    window.draw(marker);
+
+    // Legend above the strip, each label in its curve's colour
+    const SortednessMetrics& shown = history.metrics();
+    std::ostringstream status;
+    status << "Step " << history.position() + 1 << " of " << steps << (history.seekable() ? " (click to seek)" : "");
+    drawCaption(window, status.str(), area.left, area.top - 22.f, font);
+    float x = area.left + 250.f;
+    auto legend = [&](const std::string& label, sf::Color color) {
+        sf::Text text;
+        text.setFont(font);
+        text.setString(label);
+        text.setCharacterSize(16);
+        text.setFillColor(color);
+        text.setPosition(x, area.top - 22.f);
+        window.draw(text);
+        x += text.getLocalBounds().width + 24.f;
+    };
+    std::ostringstream sorted;
+    sorted << std::fixed << std::setprecision(1) << "inversions " << shown.inversions << " ("
+           << shown.sortedFraction() * 100.0 << "% of pairs sorted)";
+    legend(sorted.str(), sortedColor);
+    legend("longest run " + std::to_string(shown.longestRun), runColor);
+    legend("in place " + std::to_string(shown.inPlace) + "/" + std::to_string(shown.n), placeColor);
+    if (!previousRun.empty()) legend("previous run", sf::Color(150, 150, 150));
+}
+
+int minimapStepAt(const sf::Vector2u& targetSize, const RunHistory& history, sf::Vector2f point) {
+    if (history.steps() < 2 || !history.seekable()) return -1;
+    const sf::FloatRect area = minimapArea(targetSize);
+    if (!area.contains(point.x, point.y)) return -1;
+    float along = (point.x - area.left) / area.width;
+    return static_cast<int>(std::lround(along * (history.steps() - 1)));
+}
+
+void drawStatsOverlay(sf::RenderTarget& window, const std::string& statsText,
+                    const sf::Font& font) {
+    sf::Text text;
+    text.setFont(font);
+    text.setString(statsText);
+    text.setCharacterSize(14);
+    text.setFillColor(sf::Color(60, 60, 60));
+
+    sf::FloatRect bounds = text.getLocalBounds();
+    text.setPosition(window.getSize().x - bounds.width - 20.f,
+                     window.getSize().y - bounds.height - 20.f);
+    window.draw(text);
+}
+
+bool RetainedScene::create(unsigned width, unsigned height, unsigned bandHeight) {
+    band = std::min(bandHeight, height > 0 ? height - 1 : 0);
+    for (size_t i = 0; i < kLayerCount; ++i) {
+        unsigned layerHeight = height;
+        if (i == static_cast<size_t>(SceneLayer::Minimap)) layerHeight = std::max(1u, band);
+        else if (i != static_cast<size_t>(SceneLayer::Stats)) layerHeight = height - band;
+        if (!layers[i].create(width, layerHeight)) return false;
+    }
+    invalidateAll();
+    return true;
+}
+
+sf::Vector2f RetainedScene::origin(SceneLayer layer) const {
+    bool belowBand = layer == SceneLayer::View || layer == SceneLayer::Text;
+    return sf::Vector2f(0.f, belowBand ? static_cast<float>(band) : 0.f);
+}
+
+sf::Vector2u RetainedScene::size(SceneLayer layer) const {
+    return layers[static_cast<size_t>(layer)].getSize();
+}
+
+void RetainedScene::invalidate(SceneLayer layer) {
+    dirty[static_cast<size_t>(layer)] = true;
+}
+
+void RetainedScene::invalidate(SceneLayer layer, const sf::FloatRect& area) {
+    // Whole pixels inside the layer, so the clip and the eraser agree
+    const sf::Vector2u layerSize = size(layer);
+    float left = std::max(0.f, std::floor(area.left));
+    float top = std::max(0.f, std::floor(area.top));
+    float right = std::min(static_cast<float>(layerSize.x), std::ceil(area.left + area.width));
+    float bottom = std::min(static_cast<float>(layerSize.y), std::ceil(area.top + area.height));
+    if (right <= left || bottom <= top) return;
+
+    sf::FloatRect& damage = damaged[static_cast<size_t>(layer)];
+    if (damage.width > 0.f) {
+        left = std::min(left, damage.left);
+        top = std::min(top, damage.top);
+        right = std::max(right, damage.left + damage.width);
+        bottom = std::max(bottom, damage.top + damage.height);
+    }
+    damage = sf::FloatRect(left, top, right - left, bottom - top);
+}
+
+void RetainedScene::invalidateAll() {
+    dirty.fill(true);
+}
+
+bool RetainedScene::isDirty() const {
+    return std::find(dirty.begin(), dirty.end(), true) != dirty.end() ||
+           std::any_of(damaged.begin(), damaged.end(), [](const sf::FloatRect& area) { return area.width > 0.f; });
+}
+
+void RetainedScene::present(sf::RenderWindow& window, const sf::Color& background,
+                            const std::function<void(SceneLayer, sf::RenderTarget&)>& drawLayer) {
+    if (!isDirty()) return;
+
+    for (size_t i = 0; i < kLayerCount; ++i) {
+        sf::RenderTexture& layer = layers[i];
+        sf::FloatRect& damage = damaged[i];
+        if (dirty[i]) {
+            layer.clear(sf::Color::Transparent);
+            drawLayer(static_cast<SceneLayer>(i), layer);
+            layer.display();
+            redraws++;
+        } else if (damage.width > 0.f) {
+            // A view onto just the damaged pixels, with the viewport placing
+            // it where they are: drawLayer draws as usual and only those
+            // pixels are touched
+            const sf::Vector2u layerSize = layer.getSize();
+            sf::View clip(damage);
+            clip.setViewport(sf::FloatRect(damage.left / layerSize.x, damage.top / layerSize.y,
+                                           damage.width / layerSize.x, damage.height / layerSize.y));
+            layer.setView(clip);
+            sf::RectangleShape eraser(sf::Vector2f(damage.width, damage.height));
+            eraser.setPosition(damage.left, damage.top);
+            eraser.setFillColor(sf::Color::Transparent);
+            layer.draw(eraser, sf::BlendNone);
+            drawLayer(static_cast<SceneLayer>(i), layer);
+            layer.setView(layer.getDefaultView());
+            layer.display();
+            partialRedraws++;
+        }
+        dirty[i] = false;
+        damage = sf::FloatRect();
+    }
+
+    window.clear(background);
+    for (size_t i = 0; i < kLayerCount; ++i) {
+        sf::Sprite sprite(layers[i].getTexture());
+        sf::Vector2f position = origin(static_cast<SceneLayer>(i));
+        sprite.setPosition(position.x, position.y);
+        window.draw(sprite);
+    }
+    window.display();
+    frames++;
 }
\ No newline at end of file
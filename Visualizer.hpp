@@ -1,53 +1,113 @@
-#pragma once
-
-#include <SFML/Graphics.hpp>
-#include <vector>
-#include <string>
-#include <algorithm>
-
-struct QuickSortStep {
-    std::vector<int> array;
-    int pivotIndex;
-    int comparingIndex;
-    int leftBound;
-    int rightBound;
-    std::string explanation;
-    std::vector<int> leftPartition;
-    std::vector<int> rightPartition;
-};
-
-struct SortStats {
-    int comparisons = 0;
-    int swaps = 0;
-    double timeTaken = 0.0;
-    std::string timeComplexity;
-    std::string spaceComplexity;
-};
-
-struct VisualizerState {
-    std::vector<int> array;
-    std::vector<float> floatArray;
-    std::vector<std::vector<float>> bucketData;
-    std::vector<QuickSortStep> quickSortSteps;
-    std::vector<int> countArray;
-    int currentQuickStep = 0;
-    int currentDigit = -1;
-    int highlightedIndex = -1;
-    int secondaryIndex = -1;
-    float speed = 1.0f;
-    bool isSorting = false;
-    std::string currentStep;
-};
-
-void drawArray(sf::RenderWindow& window, const std::vector<int>& array, 
-             int highlightedIndex, int secondaryIndex, const sf::Font& font);
-void drawQuickSortVisualization(sf::RenderWindow& window, const QuickSortStep& step, 
-                              const VisualizerState& state, const SortStats& stats,
-                              const sf::Font& font);
-void drawBuckets(sf::RenderWindow& window, const std::vector<std::vector<float>>& buckets,
-               const std::string& currentStep, const sf::Font& font);
-void drawCountingSort(sf::RenderWindow& window, const std::vector<int>& array,
-                    const std::vector<int>& countArray, int highlightedIndex,
-                    const sf::Font& font);
-void drawExplanation(sf::RenderWindow& window, const std::string& stepText, 
-                   const sf::Font& font);
\ No newline at end of file
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <array>
+#include <functional>
+#include "VisualizerState.hpp"
+#include "Sortedness.hpp"
+
+void drawArray(sf::RenderTarget& window, const std::vector<int>& array, 
+             int highlightedIndex, int secondaryIndex, const sf::Font& font,
+             const std::vector<int>& runBoundaries = {}, bool galloping = false,
+             const std::vector<bool>& discarded = {},
+             const std::vector<int>& threadOf = {});
+void drawArray(sf::RenderTarget& window, const int* array, size_t size,
+             int highlightedIndex, int secondaryIndex, const sf::Font& font,
+             const std::vector<int>& runBoundaries = {}, bool galloping = false,
+             const std::vector<bool>& discarded = {},
+             const std::vector<int>& threadOf = {});
+// Part of the target that drawArray's boxes first..last cover, outlines
+// included, when `size` elements are drawn into a target of `targetSize`
+sf::FloatRect arrayBoxesArea(const sf::Vector2u& targetSize, size_t size, int first, int last);
+void drawQuickSortVisualization(sf::RenderTarget& window, const QuickSortStep& step, 
+                              const VisualizerState& state, const SortStats& stats,
+                              const sf::Font& font);
+// Both views fall back to a binned summary once the rows or boxes no longer
+// fit. Pass the incrementally maintained reduction when there is one; if it
+// is missing or out of step with the data it is rebuilt for this frame.
+void drawBuckets(sf::RenderTarget& window, const BucketList& buckets, const sf::Font& font,
+               const BinnedHistogram* fill = nullptr);
+void drawCountingSort(sf::RenderTarget& window, const std::vector<int>& array,
+                    const std::vector<int>& countArray, int highlightedIndex,
+                    const sf::Font& font, const BinnedHistogram* countBins = nullptr);
+void drawCountingSort(sf::RenderTarget& window, const int* array, size_t arraySize,
+                    const int* countArray, size_t countSize, int highlightedIndex,
+                    const sf::Font& font, const BinnedHistogram* countBins = nullptr);
+// The implicit d-ary heap in array[0, heapSize) drawn as a tree below the
+// array row: level l holds arity^l nodes and node i's parent is (i-1)/arity
+void drawHeapTree(sf::RenderTarget& window, const std::vector<int>& array, int heapSize,
+                int arity, int highlightedIndex, int secondaryIndex, const sf::Font& font);
+void drawStringArray(sf::RenderTarget& window, const std::vector<std::string>& strings,
+                   int rangeStart, int rangeEnd, int depth, const sf::Font& font);
+void drawSortedRuns(sf::RenderTarget& window, const std::vector<int>& buffer,
+                  const std::vector<std::vector<int>>& runs, bool highlightNewest,
+                  const sf::Font& font);
+void drawExplanation(sf::RenderTarget& window, const std::string& stepText, 
+                   const sf::Font& font);
+// Sortedness over the whole run as a strip of curves under the view, each
+// rising to the top once sorted: sorted pairs (1 - inversions / max),
+// longest run / n and elements in place / n. The shown step is marked, and
+// a previous run's sorted-pairs curve can be drawn in grey to compare.
+void drawProgressMinimap(sf::RenderTarget& window, const RunHistory& history, const sf::Font& font,
+                       const std::vector<float>& previousRun = {});
+// Step of the run under a click on the minimap, or -1 when the click misses
+// it or the history cannot seek. `point` is in the coordinates of the
+// target of `targetSize` the minimap was drawn into.
+int minimapStepAt(const sf::Vector2u& targetSize, const RunHistory& history, sf::Vector2f point);
+// CPU and heap/arena counters in the bottom-right corner, clear of the step text
+void drawStatsOverlay(sf::RenderTarget& window, const std::string& statsText,
+                    const sf::Font& font);
+
+// The frame is kept as one cached texture per layer. A layer is rasterised
+// again only after it has been invalidated; present() then composites the
+// cached layers, so an unchanged view costs a textured quad instead of a
+// full redraw.
+enum class SceneLayer { Minimap, View, Text, Stats, Count };
+
+// Height of the band across the top of the window that holds the minimap
+constexpr unsigned kMinimapBandHeight = 90;
+
+class RetainedScene {
+public:
+    // The minimap layer is a band of bandHeight pixels across the top; the
+    // view and text layers fill the window below it, so views keep their
+    // layout whether or not a minimap is shown. Stats covers the window.
+    // Can be called again, e.g. after the window is resized.
+    bool create(unsigned width, unsigned height, unsigned bandHeight = 0);
+
+    // Window position of a layer's (0, 0), and its size
+    sf::Vector2f origin(SceneLayer layer) const;
+    sf::Vector2u size(SceneLayer layer) const;
+
+    void invalidate(SceneLayer layer);
+    // Marks only `area` of the layer (in its own coordinates) stale; the next
+    // present() erases and redraws just those pixels. Areas invalidated
+    // before then are merged into their bounding box.
+    void invalidate(SceneLayer layer, const sf::FloatRect& area);
+    void invalidateAll();
+    bool isDirty() const;
+
+    // Redraws the dirty layers through drawLayer, then composites every
+    // layer onto the window and displays it. Does nothing when clean.
+    void present(sf::RenderWindow& window, const sf::Color& background,
+                 const std::function<void(SceneLayer, sf::RenderTarget&)>& drawLayer);
+
+    size_t framesPresented() const { return frames; }
+    size_t layersRedrawn() const { return redraws; }
+    size_t areasRedrawn() const { return partialRedraws; }
+
+private:
+    static constexpr size_t kLayerCount = static_cast<size_t>(SceneLayer::Count);
+
+    std::array<sf::RenderTexture, kLayerCount> layers;
+    std::array<bool, kLayerCount> dirty{};
+    std::array<sf::FloatRect, kLayerCount> damaged{};  // width 0: nothing
+    unsigned band = 0;
+    size_t frames = 0;
+    size_t redraws = 0;
+    size_t partialRedraws = 0;
+};
\ No newline at end of file
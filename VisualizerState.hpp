@@ -0,0 +1,127 @@
+#pragma once
+
+#ifndef VISUALIZER_STATE_HPP
+#define VISUALIZER_STATE_HPP
+
+// What the sorts record for the views, kept free of SFML so the headless
+// kernels and the benchmark build without it.
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+
+// Allocator-aware, so a std::pmr::vector<QuickSortStep> keeps every step's
+// buffers in its own memory resource (the per-sort arena). A plain copy
+// falls back to the default resource, as with any pmr type.
+struct QuickSortStep {
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::vector<int> array;
+    int pivotIndex = -1;
+    int comparingIndex = -1;
+    int leftBound = -1;
+    int rightBound = -1;
+    std::pmr::string explanation;
+    std::pmr::vector<int> leftPartition;
+    std::pmr::vector<int> rightPartition;
+
+    QuickSortStep() = default;
+    QuickSortStep(const QuickSortStep&) = default;
+    QuickSortStep(QuickSortStep&&) = default;
+    QuickSortStep& operator=(const QuickSortStep&) = default;
+    QuickSortStep& operator=(QuickSortStep&&) = default;
+
+    explicit QuickSortStep(const allocator_type& alloc)
+        : array(alloc), explanation(alloc), leftPartition(alloc), rightPartition(alloc) {}
+    QuickSortStep(const QuickSortStep& other, const allocator_type& alloc)
+        : array(other.array, alloc), pivotIndex(other.pivotIndex),
+          comparingIndex(other.comparingIndex), leftBound(other.leftBound),
+          rightBound(other.rightBound), explanation(other.explanation, alloc),
+          leftPartition(other.leftPartition, alloc), rightPartition(other.rightPartition, alloc) {}
+    QuickSortStep(QuickSortStep&& other, const allocator_type& alloc)
+        : array(std::move(other.array), alloc), pivotIndex(other.pivotIndex),
+          comparingIndex(other.comparingIndex), leftBound(other.leftBound),
+          rightBound(other.rightBound), explanation(std::move(other.explanation), alloc),
+          leftPartition(std::move(other.leftPartition), alloc),
+          rightPartition(std::move(other.rightPartition), alloc) {}
+};
+
+struct SortStats {
+    int comparisons = 0;
+    int swaps = 0;
+    double timeTaken = 0.0;
+    std::string timeComplexity;
+    std::string spaceComplexity;
+};
+
+// Per-bin sums over a long series (bucket fill levels, a count array), kept
+// current one update at a time so large views draw from at most kMaxBins
+// values instead of rescanning the series every frame. Header-only because
+// the sorts maintain it and the headless benchmark does not link the views.
+class BinnedHistogram {
+public:
+    static constexpr size_t kMaxBins = 512;
+
+    // Zeroes every value; bins cover ceil(valueCount / kMaxBins) values each
+    void reset(size_t valueCount) {
+        values = valueCount;
+        width = std::max<size_t>(1, (valueCount + kMaxBins - 1) / kMaxBins);
+        sums.assign((valueCount + width - 1) / width, 0);
+    }
+    void assign(const int* data, size_t valueCount) {
+        reset(valueCount);
+        for (size_t i = 0; i < valueCount; ++i) sums[i / width] += data[i];
+    }
+    void add(size_t index, long long delta) { sums[index / width] += delta; }
+
+    size_t valueCount() const { return values; }
+    size_t binWidth() const { return width; }
+    size_t binCount() const { return sums.size(); }
+    long long bin(size_t b) const { return sums[b]; }
+    long long maxBin() const {
+        return sums.empty() ? 0 : *std::max_element(sums.begin(), sums.end());
+    }
+
+private:
+    size_t values = 0;
+    size_t width = 1;
+    std::vector<long long> sums;
+};
+
+// Buckets share one memory resource with their outer vector
+using BucketList = std::pmr::vector<std::pmr::vector<float>>;
+
+struct VisualizerState {
+    // Buckets, QuickSort steps and sort temporaries come from `memory`. The
+    // visualizer passes its per-sort arena, which is not thread-safe, so
+    // anything else should leave the default (global heap) resource.
+    explicit VisualizerState(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : memory(memory), bucketData(memory), quickSortSteps(memory) {}
+
+    std::pmr::memory_resource* memory;
+    std::vector<int> array;
+    std::vector<float> floatArray;
+    std::vector<std::string> stringArray;
+    BucketList bucketData;
+    std::pmr::vector<QuickSortStep> quickSortSteps;
+    std::vector<int> countArray;
+    BinnedHistogram countBins;    // countArray, binned
+    BinnedHistogram bucketFill;   // bucketData sizes, binned
+    std::vector<int> runBoundaries;
+    bool galloping = false;
+    std::vector<bool> discarded;
+    std::vector<int> threadOf;    // per element: worker thread that owns it, -1 none
+    int heapArity = 0;            // nonzero while heapSort shows its tree
+    int heapSize = 0;             // array[0, heapSize) is the heap
+    int currentQuickStep = 0;
+    int currentDigit = -1;
+    int highlightedIndex = -1;
+    int secondaryIndex = -1;
+    float speed = 1.0f;
+    bool isSorting = false;
+    std::string currentStep;
+};
+
+#endif // VISUALIZER_STATE_HPP
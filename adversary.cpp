@@ -0,0 +1,141 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
+#include <limits>
+#include "AdversarialSearch.hpp"
+
+// Searches for inputs that make one algorithm as slow as possible and saves
+// the worst as a dataset for the visualizer (D) and benchmark (--dataset):
+//   g++ -O2 -std=c++20 -pthread adversary.cpp AdversarialSearch.cpp -o adversary
+//   ./adversary quickSort 16
+//   ./adversary bucketSort 1000 --generations 500 --out datasets/skewed_buckets.txt
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: adversary <target> [n] [--objective comparisons|time] [--generations G]\n"
+                 "                 [--threads T] [--seed S] [--no-antiqsort] [--no-extremes] [--out path]\n"
+                 "targets:";
+    for (const adversary::Target& target : adversary::targets()) std::cerr << " " << target.name;
+    std::cerr << "\n";
+}
+
+// Whole decimal argument of at least 1; atoi's silent 0 would run no search
+bool parsePositive(const std::string& text, long long& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0' && errno == 0 && value >= 1;
+}
+
+// "std::sort" -> "std_sort", for file names
+std::string fileSafe(const std::string& name) {
+    std::string safe;
+    for (char c : name) {
+        if (std::isalnum(static_cast<unsigned char>(c))) safe += c;
+        else if (safe.empty() || safe.back() != '_') safe += '_';
+    }
+    return safe;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    const adversary::Target* target = adversary::findTarget(argv[1]);
+    if (!target) {
+        std::cerr << "unknown target " << argv[1] << "\n";
+        usage();
+        return 2;
+    }
+
+    adversary::SearchOptions options;
+    std::string outPath;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--objective" && hasValue) {
+            std::string objective = argv[++i];
+            if (objective == "time") options.objective = adversary::Objective::Time;
+            else if (objective != "comparisons") {
+                usage();
+                return 2;
+            }
+        }
+        else if (arg == "--generations" && hasValue) {
+            long long generations = 0;
+            if (!parsePositive(argv[++i], generations) || generations > std::numeric_limits<int>::max()) {
+                std::cerr << "--generations needs a positive count, got " << argv[i] << "\n";
+                usage();
+                return 2;
+            }
+            options.generations = static_cast<int>(generations);
+        }
+        else if (arg == "--threads" && hasValue) options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--no-antiqsort") options.seedWithAntiqsort = false;
+        else if (arg == "--no-extremes") options.seedWithExtremes = false;
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (!arg.empty() && arg[0] != '-') {
+            long long n = 0;
+            if (!parsePositive(arg, n)) {
+                std::cerr << "n must be a positive element count, got " << arg << "\n";
+                usage();
+                return 2;
+            }
+            options.n = static_cast<size_t>(n);
+        }
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    const bool byTime = options.objective == adversary::Objective::Time;
+    const char* unit = byTime ? "us" : "comparisons";
+    std::cout << "Searching " << target->name << ", n = " << options.n << ", maximising "
+              << (byTime ? "time" : "comparisons") << "\n";
+
+    adversary::SearchResult result = adversary::search(*target, options, [&](int generation, double best) {
+        if ((generation + 1) % 25 == 0) {
+            std::cout << "  generation " << std::setw(5) << generation + 1 << "  worst so far "
+                      << std::fixed << std::setprecision(byTime ? 1 : 0) << best << " " << unit << "\n";
+        }
+    });
+
+    std::cout << std::fixed << std::setprecision(byTime ? 1 : 0)
+              << "Worst input: " << result.worstScore << " " << unit << " (random inputs: "
+              << result.randomScore << ", " << std::setprecision(1)
+              << (result.randomScore > 0 ? result.worstScore / result.randomScore : 0.0) << "x) after "
+              << result.evaluations << " evaluations, " << result.method << "\n";
+
+    if (result.worst.empty()) {
+        std::cerr << "The search produced no input; nothing saved\n";
+        return 1;
+    }
+    if (outPath.empty()) {
+        outPath = "datasets/worst_" + fileSafe(target->name) + "_n" + std::to_string(options.n) +
+                  (byTime ? "_time" : "") + ".txt";
+    }
+    adversary::Dataset dataset;
+    dataset.target = target->name;
+    dataset.objective = byTime ? "time" : "comparisons";
+    dataset.method = result.method;
+    dataset.score = result.worstScore;
+    dataset.randomScore = result.randomScore;
+    dataset.seed = options.seed;
+    dataset.scale = target->permutation ? 1 : adversary::kBucketScale;
+    dataset.values = result.worst;
+    if (!adversary::saveDataset(outPath, dataset)) {
+        std::cerr << "Could not write " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "Saved " << outPath << "\n";
+    return 0;
+}
@@ -0,0 +1,1132 @@
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <limits>
+#include <set>
+#include <memory>
+#include <thread>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+#include "SortAlgorithms.hpp"
+#include "StreamingContainer.hpp"
+#include "SortMemory.hpp"
+#include "Profiler.hpp"
+#include "SortKernels.hpp"
+#include "AdversarialSearch.hpp"
+#include "Sortedness.hpp"
+
+// Headless benchmark for the sort kernels. Build it next to the visualizer:
+//   g++ -O2 -std=c++20 -pthread benchmark.cpp SortAlgorithms.cpp StreamingContainer.cpp Profiler.cpp SortMemory.cpp SortKernels.cpp
+//       AdversarialSearch.cpp Sortedness.cpp -o benchmark
+// No window is opened and every visual callback is a no-op, so timings
+// measure the algorithms (plus whatever per-step work they do internally).
+//
+//   ./benchmark [--plugin lib.so]... [--dataset file]... [sizes...]
+//                                     report tables; plug-in kernels join the
+//                                     registered-kernel table, and adversary
+//                                     datasets are run as extra inputs
+//   ./benchmark --record [file]       sample every regression case into a baseline
+//   ./benchmark --compare [file] [%]  re-sample and test against that baseline;
+//                                     exits 1 if any case got significantly slower
+
+namespace {
+
+const int kRepeats = 3;
+// Largest non-random input a kernel with a quadratic worst case is run on
+const size_t kQuadraticKernelLimit = 10000;
+
+// Keeps query results alive so the optimizer cannot drop the loops
+volatile size_t benchSink = 0;
+
+// Chosen algorithm may be this much slower than the fastest candidate
+const double kDispatchTolerance = 0.25;
+
+std::vector<float> uniformFloats(size_t n, float min, float max, unsigned seed) {
+    std::vector<float> arr(n);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(min, max);
+    for (float& num : arr) num = dist(gen);
+    return arr;
+}
+
+std::vector<double> uniformDoubles(size_t n, double min, double max, unsigned seed) {
+    std::vector<double> arr(n);
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> dist(min, max);
+    for (double& num : arr) num = dist(gen);
+    return arr;
+}
+
+std::vector<int> intInput(const std::string& distribution, size_t n, unsigned seed) {
+    std::vector<int> arr(n);
+    std::mt19937 gen(seed);
+    if (distribution == "random") {
+        std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+        for (int& num : arr) num = dist(gen);
+    } else if (distribution == "small-range") {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n / 4));
+        for (int& num : arr) num = dist(gen);
+    } else if (distribution == "few-unique") {
+        std::uniform_int_distribution<int> dist(0, 7);
+        for (int& num : arr) num = dist(gen) * 1000003;
+    } else if (distribution == "sorted") {
+        for (size_t i = 0; i < n; i++) arr[i] = static_cast<int>(i);
+    } else if (distribution == "reversed") {
+        for (size_t i = 0; i < n; i++) arr[i] = static_cast<int>(n - i);
+    } else if (distribution == "sorted+tail") {
+        // Presorted body with 1% random values appended
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n));
+        size_t body = n - n / 100;
+        for (size_t i = 0; i < n; i++) arr[i] = i < body ? static_cast<int>(i) : dist(gen);
+    } else {
+        std::uniform_int_distribution<int> dist(0, 1 << 30);
+        for (int& num : arr) num = dist(gen);
+    }
+    return arr;
+}
+
+// Runs `prepare` then `run` kRepeats times and returns the median of `run`
+double medianMs(const std::function<void()>& prepare, const std::function<void()>& run) {
+    std::vector<double> times;
+    for (int r = 0; r < kRepeats; r++) {
+        prepare();
+        auto startTime = std::chrono::high_resolution_clock::now();
+        run();
+        auto endTime = std::chrono::high_resolution_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+void printHeader(const std::string& title) {
+    std::cout << "\n== " << title << " ==\n"
+              << std::left << std::setw(22) << "algorithm"
+              << std::right << std::setw(10) << "n"
+              << std::setw(12) << "ms"
+              << std::setw(14) << "Melem/s"
+              << std::setw(12) << "relative" << "\n";
+}
+
+void printRow(const std::string& name, size_t n, double ms, double baselineMs) {
+    double melemPerSec = ms > 0 ? n / ms / 1000.0 : 0.0;
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::setw(10) << n
+              << std::setw(12) << std::fixed << std::setprecision(3) << ms
+              << std::setw(14) << std::setprecision(2) << melemPerSec
+              << std::setw(11) << std::setprecision(2) << (ms > 0 ? baselineMs / ms : 0.0) << "x\n";
+}
+
+void benchFloatSorts(const std::vector<size_t>& sizes) {
+    printHeader("Float keys, uniform [0,1) (relative to bucketSort)");
+    auto noFloatStep = [](const std::vector<float>&, int, int, const std::string&) {};
+    auto noDoubleStep = [](const std::vector<double>&, int, int, const std::string&) {};
+    auto noBucketStep = [](const BucketList&, const std::string&) {};
+
+    for (size_t n : sizes) {
+        const std::vector<float> input = uniformFloats(n, 0.0f, 1.0f, 42);
+        std::vector<float> work;
+
+        // bucketSort sleeps between visual steps; a huge speed makes that a no-op
+        VisualizerState state;
+        state.speed = 1e9f;
+        SortStats stats;
+        double bucketMs = medianMs([&] { work = input; },
+                                   [&] { bucketSort(work, stats, state, noBucketStep); });
+        printRow("bucketSort", n, bucketMs, bucketMs);
+
+        double radixMs = medianMs([&] { work = input; },
+                                  [&] { floatRadixSort(work, noFloatStep); });
+        printRow("floatRadixSort", n, radixMs, bucketMs);
+
+        double stdMs = medianMs([&] { work = input; },
+                                [&] { std::sort(work.begin(), work.end()); });
+        printRow("std::sort", n, stdMs, bucketMs);
+
+        const std::vector<double> doubles = uniformDoubles(n, -1.0, 1.0, 42);
+        std::vector<double> doubleWork;
+        double doubleMs = medianMs([&] { doubleWork = doubles; },
+                                   [&] { doubleRadixSort(doubleWork, noDoubleStep); });
+        printRow("doubleRadixSort", n, doubleMs, bucketMs);
+    }
+}
+
+// Time versus k for the selection kernels, against one full sort
+void benchSelection(const std::vector<size_t>& sizes) {
+    size_t n = *std::max_element(sizes.begin(), sizes.end());
+    const std::vector<int> input = intInput("random", n, 11);
+    std::vector<int> work;
+
+    double fullMs = medianMs([&] { work = input; }, [&] { std::sort(work.begin(), work.end()); });
+    std::cout << "\n== Selection vs full sort, n = " << n << " (std::sort: "
+              << std::fixed << std::setprecision(3) << fullMs << "ms) ==\n"
+              << std::right << std::setw(10) << "k"
+              << std::setw(16) << "quickSelect ms"
+              << std::setw(12) << "topK ms"
+              << std::setw(16) << "partialSort ms" << "\n";
+
+    std::vector<size_t> ks = {1, 10, 100, 1000, n / 100, n / 10, n / 2};
+    std::sort(ks.begin(), ks.end());
+    ks.erase(std::unique(ks.begin(), ks.end()), ks.end());
+    for (size_t k : ks) {
+        if (k == 0 || k > n) continue;
+        int kk = static_cast<int>(k);
+        double selectMs = medianMs([&] { work = input; }, [&] { quickSelect(work, kk - 1); });
+        double topMs = medianMs([] {}, [&] { topK(input, kk); });
+        double partialMs = medianMs([&] { work = input; }, [&] { partialSort(work, kk); });
+        std::cout << std::setw(10) << k
+                  << std::setw(16) << selectMs
+                  << std::setw(12) << topMs
+                  << std::setw(16) << partialMs << "\n";
+    }
+}
+
+// Streaming ingest: inserts/sec and rank-query latency for the sorted-chunk
+// store, with std::multiset as the node-based baseline
+void benchStreaming(const std::vector<size_t>& sizes) {
+    std::cout << "\n== Streaming inserts ==\n"
+              << std::left << std::setw(22) << "container"
+              << std::right << std::setw(10) << "n"
+              << std::setw(16) << "Minserts/s"
+              << std::setw(16) << "query us" << "\n";
+
+    const int queries = 10000;
+    for (size_t n : sizes) {
+        const std::vector<int> input = intInput("non-negative", n, 13);
+        std::vector<int> probes = intInput("non-negative", queries, 17);
+        size_t sink = 0;
+
+        SortedChunkStore store;
+        double storeInsertMs = medianMs([&] { store.clear(); }, [&] { for (int v : input) store.insert(v); });
+        double storeQueryMs = medianMs([] {}, [&] { for (int v : probes) sink += store.countLess(v); });
+
+        std::multiset<int> tree;
+        double treeInsertMs = medianMs([&] { tree.clear(); }, [&] { for (int v : input) tree.insert(v); });
+        // Rank in a multiset is a linear walk; time membership instead
+        double treeQueryMs = medianMs([] {}, [&] { for (int v : probes) sink += tree.count(v); });
+
+        std::cout << std::left << std::setw(22) << "SortedChunkStore"
+                  << std::right << std::setw(10) << n << std::fixed << std::setprecision(2)
+                  << std::setw(16) << n / storeInsertMs / 1000.0
+                  << std::setw(16) << storeQueryMs * 1000.0 / queries << "\n"
+                  << std::left << std::setw(22) << "std::multiset"
+                  << std::right << std::setw(10) << n
+                  << std::setw(16) << n / treeInsertMs / 1000.0
+                  << std::setw(16) << treeQueryMs * 1000.0 / queries << "\n";
+        benchSink = sink;
+    }
+}
+
+// Strong scaling: one fixed input, 1 thread up to every hardware thread.
+// Speedup and efficiency are against parallelSampleSort on one thread;
+// std::sort is the sequential reference.
+void benchSampleSortScaling(const std::vector<size_t>& sizes) {
+    size_t n = *std::max_element(sizes.begin(), sizes.end());
+    const std::vector<int> input = intInput("random", n, 43);
+    std::vector<int> work;
+    unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    double stdMs = medianMs([&] { work = input; }, [&] { std::sort(work.begin(), work.end()); });
+    std::cout << "\n== Sample sort strong scaling, n = " << n << " (std::sort: "
+              << std::fixed << std::setprecision(3) << stdMs << "ms, "
+              << hardwareThreads << " hardware threads) ==\n"
+              << std::right << std::setw(10) << "threads"
+              << std::setw(12) << "ms"
+              << std::setw(14) << "Melem/s"
+              << std::setw(12) << "speedup"
+              << std::setw(14) << "efficiency" << "\n";
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < hardwareThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hardwareThreads);
+
+    double oneThreadMs = 0.0;
+    for (unsigned threads : threadCounts) {
+        double ms = medianMs([&] { work = input; }, [&] { parallelSampleSort(work, threads); });
+        if (threads == 1) oneThreadMs = ms;
+        double speedup = ms > 0 ? oneThreadMs / ms : 0.0;
+        std::cout << std::setw(10) << threads
+                  << std::setw(12) << std::setprecision(3) << ms
+                  << std::setw(14) << std::setprecision(2) << (ms > 0 ? n / ms / 1000.0 : 0.0)
+                  << std::setw(11) << speedup << "x"
+                  << std::setw(13) << std::setprecision(0) << speedup / threads * 100.0 << "%\n";
+    }
+}
+
+// heapSort by arity against the quicksort family, with hardware cache
+// misses per element for one run where the counters are available
+// Counter events per element over one run, or "n/a" without a counter
+std::string missesPerElement(profiler::HardwareCounter& counter, const std::function<void()>& run, size_t n) {
+    counter.start();
+    run();
+    long long misses = counter.stop();
+    std::ostringstream out;
+    if (misses < 0) out << "n/a";
+    else out << std::fixed << std::setprecision(3) << static_cast<double>(misses) / n;
+    return out.str();
+}
+
+void benchHeapSort(const std::vector<size_t>& sizes) {
+    std::cout << "\n== Heap sort by arity (relative to std::sort introsort) ==\n"
+              << std::left << std::setw(22) << "algorithm"
+              << std::right << std::setw(10) << "n"
+              << std::setw(12) << "ms"
+              << std::setw(12) << "relative"
+              << std::setw(16) << "LLC miss/elem"
+              << std::setw(16) << "L1D miss/elem" << "\n";
+
+    profiler::HardwareCounter llcMisses(profiler::HardwareEvent::CacheMisses);
+    profiler::HardwareCounter l1Misses(profiler::HardwareEvent::L1DataReadMisses);
+
+    for (size_t n : sizes) {
+        const std::vector<int> input = intInput("random", n, 47);
+        std::vector<int> work;
+        // baselineMs 0 makes the row its own baseline
+        auto row = [&](const std::string& name, const std::function<void()>& run, double baselineMs) {
+            double ms = medianMs([&] { work = input; }, run);
+            if (baselineMs <= 0) baselineMs = ms;
+            work = input;
+            std::string llc = missesPerElement(llcMisses, run, n);
+            work = input;
+            std::string l1 = missesPerElement(l1Misses, run, n);
+            std::cout << std::left << std::setw(22) << name
+                      << std::right << std::setw(10) << n
+                      << std::setw(12) << std::fixed << std::setprecision(3) << ms
+                      << std::setw(11) << std::setprecision(2) << (ms > 0 ? baselineMs / ms : 0.0) << "x"
+                      << std::setw(16) << llc
+                      << std::setw(16) << l1 << "\n";
+            return ms;
+        };
+
+        double stdMs = row("std::sort", [&] { std::sort(work.begin(), work.end()); }, 0.0);
+        for (int arity : {2, 4, 8}) {
+            row("heapSort d=" + std::to_string(arity), [&, arity] { heapSort(work, arity); }, stdMs);
+        }
+    }
+    if (!llcMisses.available()) {
+        std::cout << "(cache miss counters unavailable: not Linux, no PMU, or perf_event_paranoid > 2)\n";
+    }
+}
+
+// Headless radix, counting and bucket kernels with scatter tuning off and
+// on (huge pages, prefetch, write-combined scatter), with dTLB misses per
+// element. The tuning targets arrays past kLargeScatterElements, so one
+// such size is added when none was asked for.
+void benchScatterTuning(std::vector<size_t> sizes) {
+    if (std::none_of(sizes.begin(), sizes.end(), [](size_t n) { return n >= kLargeScatterElements; })) {
+        sizes.push_back(4 * kLargeScatterElements);
+    }
+    std::cout << "\n== Scatter tuning for large arrays (transparent huge pages: "
+              << sortmem::transparentHugePages() << ") ==\n"
+              << std::left << std::setw(14) << "kernel"
+              << std::right << std::setw(11) << "n"
+              << std::setw(12) << "tuning"
+              << std::setw(11) << "pages"
+              << std::setw(12) << "ms"
+              << std::setw(12) << "Melem/s"
+              << std::setw(14) << "dTLB ld/elem"
+              << std::setw(14) << "dTLB st/elem" << "\n";
+
+    profiler::HardwareCounter loadMisses(profiler::HardwareEvent::DataTlbLoadMisses);
+    profiler::HardwareCounter storeMisses(profiler::HardwareEvent::DataTlbStoreMisses);
+
+    // Each configuration gets freshly allocated work memory, so pages
+    // advised for one run never back the next
+    auto row = [&](const std::string& kernel, size_t n, const std::string& label, const ScatterTuning& tuning,
+                   const std::function<void()>& prepare, const std::function<void()>& run,
+                   const std::function<sortmem::PageMode()>& pagesOfWork) {
+        double ms = medianMs(prepare, run);
+        prepare();
+        std::string pages = sortmem::pageModeName(pagesOfWork());
+        std::string loads = missesPerElement(loadMisses, run, n);
+        prepare();
+        std::string stores = missesPerElement(storeMisses, run, n);
+        std::cout << std::left << std::setw(14) << kernel
+                  << std::right << std::setw(11) << n
+                  << std::setw(12) << label
+                  << std::setw(11) << (tuning.pages == sortmem::PageMode::Default ? "default" : pages)
+                  << std::setw(12) << std::fixed << std::setprecision(3) << ms
+                  << std::setw(12) << std::setprecision(1) << (ms > 0 ? n / (ms * 1000.0) : 0.0)
+                  << std::setw(14) << loads
+                  << std::setw(14) << stores << "\n";
+    };
+
+    const ScatterTuning tuned = scatterTuningFor(kLargeScatterElements);
+
+    for (size_t n : sizes) {
+        const std::vector<int> keys = intInput("random", n, 61);
+        const std::vector<int> smallKeys = intInput("small-range", n, 67);
+        const std::vector<float> floats = uniformFloats(n, 0.0f, 1.0f, 71);
+
+        for (bool on : {false, true}) {
+            const ScatterTuning tuning = on ? tuned : ScatterTuning();
+            const std::string label = on ? "on" : "off";
+            {
+                std::vector<int> work;
+                row("radixSort", n, label, tuning, [&] { work = keys; }, [&] { radixSort(work, tuning); },
+                    [&] { return sortmem::advisePages(work.data(), n * sizeof(int), tuning.pages); });
+            }
+            {
+                std::vector<int> work;
+                row("countingSort", n, label, tuning, [&] { work = smallKeys; }, [&] { countingSort(work, tuning); },
+                    [&] { return sortmem::advisePages(work.data(), n * sizeof(int), tuning.pages); });
+            }
+            {
+                std::vector<float> work;
+                row("bucketSort", n, label, tuning, [&] { work = floats; }, [&] { bucketSort(work, tuning); },
+                    [&] { return sortmem::advisePages(work.data(), n * sizeof(float), tuning.pages); });
+            }
+        }
+    }
+
+    // Prefetch distance sweep for the direct (unstaged) scatter at the largest size
+    size_t n = *std::max_element(sizes.begin(), sizes.end());
+    const std::vector<int> keys = intInput("random", n, 61);
+    for (int distance : {0, 4, 8, 16, 32, 64}) {
+        ScatterTuning tuning;
+        tuning.pages = tuned.pages;
+        tuning.prefetchDistance = distance;
+        std::vector<int> work;
+        row("radixSort", n, "pf=" + std::to_string(distance), tuning, [&] { work = keys; },
+            [&] { radixSort(work, tuning); },
+            [&] { return sortmem::advisePages(work.data(), n * sizeof(int), tuning.pages); });
+    }
+    if (!loadMisses.available()) {
+        std::cout << "(dTLB counters unavailable: not Linux, no PMU, or perf_event_paranoid > 2)\n";
+    }
+}
+
+// Every registered kernel (built-in, standard library, plug-ins) on the
+// same inputs: time relative to std::sort, heap allocations per run, and a
+// check of the output against std::sort. Saved adversary datasets are run
+// after the generated inputs. Returns the number of wrong outputs.
+int benchKernels(const std::vector<size_t>& sizes, const std::vector<adversary::Dataset>& datasets) {
+    std::cout << "\n== Registered kernels on identical inputs (relative to std::sort) ==\n"
+              << std::left << std::setw(24) << "kernel"
+              << std::setw(14) << "input"
+              << std::right << std::setw(10) << "n"
+              << std::setw(12) << "ms"
+              << std::setw(12) << "relative"
+              << std::setw(10) << "allocs"
+              << std::setw(12) << "KB"
+              << "  origin\n";
+
+    int wrong = 0;
+    auto runInput = [&](const std::string& label, const std::vector<int>& input) {
+        std::vector<int> expected = input;
+        std::sort(expected.begin(), expected.end());
+        std::vector<int> work;
+
+        double stdMs = medianMs([&] { work = input; }, [&] { std::sort(work.begin(), work.end()); });
+        for (const SortKernel& kernel : sortKernels()) {
+            if (kernel.quadraticWorstCase && input.size() > kQuadraticKernelLimit && label != "random") {
+                std::cout << std::left << std::setw(24) << kernel.name
+                          << std::setw(14) << label
+                          << std::right << std::setw(10) << input.size()
+                          << "  skipped: quadratic on this input\n";
+                continue;
+            }
+            double ms = kernel.name == "std::sort" ? stdMs
+                                                   : medianMs([&] { work = input; }, [&] { kernel.run(work); });
+
+            work = input;
+            sortmem::Counters before = sortmem::counters();
+            kernel.run(work);
+            sortmem::Counters used = sortmem::since(before, sortmem::counters());
+            bool correct = work == expected;
+            if (!correct) wrong++;
+
+            std::cout << std::left << std::setw(24) << kernel.name
+                      << std::setw(14) << label
+                      << std::right << std::setw(10) << input.size()
+                      << std::setw(12) << std::fixed << std::setprecision(3) << ms
+                      << std::setw(11) << std::setprecision(2) << (ms > 0 ? stdMs / ms : 0.0) << "x"
+                      << std::setw(10) << used.allocations
+                      << std::setw(12) << used.bytes / 1024
+                      << "  " << kernel.origin << (correct ? "" : "  WRONG OUTPUT") << "\n";
+        }
+    };
+
+    for (size_t n : sizes) {
+        for (const char* distribution : {"random", "few-unique", "sorted+tail"}) {
+            runInput(distribution, intInput(distribution, n, 53));
+        }
+    }
+    for (size_t d = 0; d < datasets.size(); d++) {
+        runInput("dataset " + std::to_string(d + 1), datasets[d].values);
+    }
+    return wrong;
+}
+
+// The visualizer's step callback copies the shown array into the array
+// being sorted, which is usually that same array. Every visual int sort
+// runs here through such a callback and must still return the sorted
+// input; a sort that shows a separate buffer mid-pass and keeps reading
+// from arr afterwards fails this. Returns the number of wrong outputs.
+int benchVisualAliasing() {
+    std::cout << "\n== Visual sorts through an aliasing step callback ==\n";
+
+    int wrong = 0;
+    for (const char* distribution : {"sorted", "small-range"}) {
+        std::vector<int> input = intInput(distribution, 64, 67);
+        std::shuffle(input.begin(), input.end(), std::mt19937(67));
+        std::vector<int> expected = input;
+        std::sort(expected.begin(), expected.end());
+
+        auto check = [&](const std::string& name, const std::function<void(std::vector<int>&)>& run) {
+            std::vector<int> work = input;
+            run(work);
+            bool correct = work == expected;
+            if (!correct) wrong++;
+            std::cout << std::left << std::setw(22) << name << std::setw(14) << distribution
+                      << (correct ? "OK" : "WRONG OUTPUT") << "\n";
+        };
+        auto shownInto = [](std::vector<int>& work) {
+            return [&work](const std::vector<int>& shown, int, int, const std::string&) { work = shown; };
+        };
+
+        check("bubbleSort", [&](std::vector<int>& work) { bubbleSort(work, shownInto(work)); });
+        check("insertionSort", [&](std::vector<int>& work) { insertionSort(work, shownInto(work)); });
+        check("radixSort", [&](std::vector<int>& work) { radixSort(work, shownInto(work)); });
+        check("countingSort", [&](std::vector<int>& work) {
+            VisualizerState state;
+            countingSort(work, shownInto(work), state);
+        });
+        check("naturalMergeSort", [&](std::vector<int>& work) {
+            VisualizerState state;
+            naturalMergeSort(work, shownInto(work), state);
+        });
+        check("heapSort", [&](std::vector<int>& work) {
+            VisualizerState state;
+            heapSort(work, shownInto(work), state);
+        });
+        check("sampleSort", [&](std::vector<int>& work) {
+            VisualizerState state;
+            sampleSort(work, shownInto(work), state);
+        });
+    }
+    return wrong;
+}
+
+// What each adversary dataset does to the algorithm it was searched
+// against, next to a typical input of the same size: a shuffled copy for
+// permutation targets, uniform keys for bucketSort (whose worst case is
+// in the key distribution, not the order).
+void benchDatasets(const std::vector<std::string>& paths, const std::vector<adversary::Dataset>& datasets) {
+    if (datasets.empty()) return;
+    std::cout << "\n== Adversary datasets (comparisons made by the targeted algorithm) ==\n"
+              << std::left << std::setw(6) << "#"
+              << std::setw(12) << "target"
+              << std::right << std::setw(10) << "n"
+              << std::setw(14) << "dataset"
+              << std::setw(14) << "typical"
+              << std::setw(10) << "ratio"
+              << "  file\n";
+
+    for (size_t d = 0; d < datasets.size(); d++) {
+        const adversary::Dataset& dataset = datasets[d];
+        const adversary::Target* target = adversary::findTarget(dataset.target);
+        if (!target) {
+            std::cout << std::left << std::setw(6) << d + 1 << std::setw(12) << dataset.target
+                      << "  unknown target, skipped  " << paths[d] << "\n";
+            continue;
+        }
+        std::mt19937 rng(59);
+        std::vector<int> typicalInput = dataset.values;
+        if (target->permutation) {
+            std::shuffle(typicalInput.begin(), typicalInput.end(), rng);
+        } else {
+            std::uniform_int_distribution<int> key(0, adversary::kBucketScale - 1);
+            for (int& value : typicalInput) value = key(rng);
+        }
+        long long worst = target->comparisons(dataset.values);
+        long long typical = target->comparisons(typicalInput);
+        std::cout << std::left << std::setw(6) << d + 1
+                  << std::setw(12) << dataset.target
+                  << std::right << std::setw(10) << dataset.values.size()
+                  << std::setw(14) << worst
+                  << std::setw(14) << typical
+                  << std::setw(9) << std::fixed << std::setprecision(1)
+                  << (typical > 0 ? static_cast<double>(worst) / typical : 0.0) << "x"
+                  << "  " << paths[d] << "\n";
+    }
+}
+
+// How soon each visual sort gets close to sorted: the share of its steps
+// spent before 75%, 90% and 99% of pairs are in order (a shuffle starts
+// near 50%), from the same RunHistory the minimap draws. The last column
+// is the time per recorded step, the sort itself included.
+void benchConvergence() {
+    const size_t n = 200;
+    std::cout << "\n== Convergence of the visual sorts (n = " << n << ", shuffled) ==\n"
+              << std::left << std::setw(22) << "algorithm"
+              << std::right << std::setw(10) << "steps"
+              << std::setw(10) << "75%"
+              << std::setw(10) << "90%"
+              << std::setw(10) << "99%"
+              << std::setw(14) << "us/step" << "\n";
+
+    // A shuffled permutation: the visual radix sort takes non-negative keys only
+    std::vector<int> input = intInput("sorted", n, 61);
+    std::shuffle(input.begin(), input.end(), std::mt19937(61));
+    auto row = [&](const std::string& name, const std::function<void(RunHistory&)>& run) {
+        RunHistory history;
+        auto start = std::chrono::steady_clock::now();
+        run(history);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        size_t steps = history.steps();
+        auto reached = [&](double fraction) {
+            for (size_t s = 0; s < steps; s++) {
+                if (history.at(s).sortedFraction() >= fraction) {
+                    std::ostringstream oss;
+                    oss << std::fixed << std::setprecision(0) << 100.0 * s / std::max<size_t>(1, steps - 1) << "%";
+                    return oss.str();
+                }
+            }
+            return std::string("-");
+        };
+        std::cout << std::left << std::setw(22) << name
+                  << std::right << std::setw(10) << steps
+                  << std::setw(10) << reached(0.75)
+                  << std::setw(10) << reached(0.9)
+                  << std::setw(10) << reached(0.99)
+                  << std::setw(14) << std::fixed << std::setprecision(2) << (steps ? us / steps : 0.0) << "\n";
+    };
+    auto recordingStep = [](RunHistory& history) {
+        return [&history](const std::vector<int>& arr, int, int, const std::string&) { history.record(arr); };
+    };
+
+    row("bubbleSort", [&](RunHistory& history) {
+        std::vector<int> work = input;
+        history.begin(work);
+        bubbleSort(work, recordingStep(history));
+    });
+    row("insertionSort", [&](RunHistory& history) {
+        std::vector<int> work = input;
+        history.begin(work);
+        insertionSort(work, recordingStep(history));
+    });
+    row("quickSort", [&](RunHistory& history) {
+        history.begin(input);
+        auto steps = quickSortStepGenerator(input, 0, static_cast<int>(n) - 1);
+        while (const QuickSortStep* step = steps.next()) history.record(step->array.data(), step->array.size());
+    });
+    row("radixSort", [&](RunHistory& history) {
+        std::vector<int> work = input;
+        history.begin(work);
+        radixSort(work, recordingStep(history));
+    });
+    row("naturalMergeSort", [&](RunHistory& history) {
+        std::vector<int> work = input;
+        VisualizerState state;
+        history.begin(work);
+        naturalMergeSort(work, recordingStep(history), state);
+    });
+    row("heapSort d=2", [&](RunHistory& history) {
+        std::vector<int> work = input;
+        VisualizerState state;
+        history.begin(work);
+        heapSort(work, recordingStep(history), state, 2);
+    });
+}
+
+// Heap allocations made by one visual sort with no-op callbacks. The step
+// sorts do O(n) to O(n^2) steps, so these sizes are fixed and kept small.
+void benchAllocations() {
+    std::cout << "\n== Allocations per visual sort ==\n"
+              << std::left << std::setw(22) << "algorithm"
+              << std::right << std::setw(10) << "n"
+              << std::setw(14) << "allocs"
+              << std::setw(14) << "heap KB"
+              << std::setw(14) << "arena KB" << "\n";
+
+    auto noStep = [](const std::vector<int>&, int, int, const std::string&) {};
+    auto noBucketStep = [](const BucketList&, const std::string&) {};
+
+    for (size_t n : {10, 100, 1000}) {
+        // Small keys, as in the visualizer; countingSort sizes its table by the max
+        const std::vector<int> input = intInput("small-range", n, 23);
+        const std::vector<float> floats = uniformFloats(n, 0.0f, 1.0f, 29);
+
+        auto measure = [&](const std::string& name, const std::function<void()>& run) {
+            sortmem::releaseArena();
+            sortmem::Counters before = sortmem::counters();
+            run();
+            sortmem::Counters used = sortmem::since(before, sortmem::counters());
+            std::cout << std::left << std::setw(22) << name
+                      << std::right << std::setw(10) << n
+                      << std::setw(14) << used.allocations
+                      << std::setw(14) << used.bytes / 1024
+                      << std::setw(14) << sortmem::arenaBytes() / 1024 << "\n";
+        };
+
+        measure("bubbleSort", [&] { std::vector<int> work = input; bubbleSort(work, noStep); });
+        measure("insertionSort", [&] { std::vector<int> work = input; insertionSort(work, noStep); });
+        measure("quickSort", [&] {
+            std::vector<int> work = input;
+            VisualizerState state(sortmem::arena());
+            quickSort(work, state, 0, (int)work.size() - 1);
+        });
+        measure("radixSort", [&] { std::vector<int> work = input; radixSort(work, noStep, sortmem::arena()); });
+        measure("countingSort", [&] {
+            std::vector<int> work = input;
+            VisualizerState state(sortmem::arena());
+            countingSort(work, noStep, state);
+        });
+        measure("bucketSort", [&] {
+            std::vector<float> work = floats;
+            VisualizerState state(sortmem::arena());
+            state.speed = 1e9f;
+            SortStats stats;
+            bucketSort(work, stats, state, noBucketStep);
+        });
+    }
+    sortmem::releaseArena();
+}
+
+// Times every candidate kernel and checks that the dispatcher's pick is
+// within kDispatchTolerance of the fastest. Returns the number of misses.
+int benchDispatcher(const std::vector<size_t>& sizes) {
+    const std::vector<std::string> distributions = {
+        "random", "non-negative", "small-range", "few-unique", "sorted", "reversed", "sorted+tail"
+    };
+    const SortChoice candidates[] = {
+        SortChoice::Insertion, SortChoice::Counting, SortChoice::Radix,
+        SortChoice::NaturalMerge, SortChoice::Introsort, SortChoice::ThreeWay
+    };
+
+    std::cout << "\n== Adaptive dispatcher (chosen vs fastest, tolerance "
+              << static_cast<int>(kDispatchTolerance * 100) << "%) ==\n";
+    int misses = 0;
+    for (size_t n : sizes) {
+        for (const std::string& distribution : distributions) {
+            const std::vector<int> input = intInput(distribution, n, 7);
+            std::vector<int> work;
+
+            InputProfile profile;
+            double analyzeMs = medianMs([] {}, [&] { profile = analyzeInput(input); });
+            SortChoice chosen = chooseAlgorithm(profile);
+
+            double chosenMs = 0.0;
+            double bestMs = 0.0;
+            SortChoice best = chosen;
+            for (SortChoice candidate : candidates) {
+                // Quadratic or huge-table candidates are only timed when picked
+                bool tooSlow = (candidate == SortChoice::Insertion && n > 20000 &&
+                                profile.estimatedInversions > 50.0 * n) ||
+                               (candidate == SortChoice::Counting && profile.range > (1 << 24));
+                if (tooSlow && candidate != chosen) continue;
+
+                double ms = medianMs([&] { work = input; }, [&] { runSortChoice(work, candidate); });
+                if (candidate == chosen) chosenMs = ms;
+                if (bestMs == 0.0 || ms < bestMs) {
+                    bestMs = ms;
+                    best = candidate;
+                }
+            }
+
+            bool ok = chosenMs <= bestMs * (1.0 + kDispatchTolerance);
+            if (!ok) misses++;
+            std::cout << std::left << std::setw(14) << distribution
+                      << std::right << std::setw(10) << n
+                      << "  chosen " << std::left << std::setw(20) << sortChoiceName(chosen)
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(10) << chosenMs << "ms"
+                      << "  best " << std::left << std::setw(20) << sortChoiceName(best)
+                      << std::right << std::setw(10) << bestMs << "ms"
+                      << "  analyze " << std::setw(8) << analyzeMs << "ms  "
+                      << (ok ? "OK" : "MISS") << "\n";
+        }
+    }
+    return misses;
+}
+
+// ---- Baseline store and regression check ----
+
+const char* const kDefaultBaselinePath = "bench_baseline.txt";
+
+// A case regresses when its throughput drops by more than the threshold
+// (default 5%) and a one-sided Mann-Whitney test puts the slowdown below
+// kSignificance. Samples within one process are tighter than the spread
+// between processes, so a flagged case is sampled again and only reported
+// if the second round agrees.
+const double kDefaultRegressionThreshold = 0.05;
+const double kSignificance = 0.01;
+
+// Sampling stops once the 95% confidence interval of the median is within
+// this fraction of the median, or when a limit is hit
+const double kTargetCiHalfWidth = 0.02;
+const size_t kMinSamples = 15;
+const size_t kMaxSamples = 300;
+const double kCaseBudgetMs = 3000.0;
+const int kWarmupRuns = 3;
+
+struct RegressionCase {
+    std::string name;  // algorithm/n/distribution
+    size_t n;
+    std::function<void()> prepare;
+    std::function<void()> run;
+};
+
+// Keeps the scheduler from migrating the timing thread between cores
+void pinToCurrentCore() {
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << GetCurrentProcessorNumber());
+#elif defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+struct MedianInterval {
+    double median;
+    double low;
+    double high;
+};
+
+// Distribution-free 95% interval for the median from order statistics
+MedianInterval medianInterval(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    const size_t n = samples.size();
+    const double spread = 1.96 * std::sqrt(static_cast<double>(n)) / 2.0;
+    size_t lowRank = static_cast<size_t>(std::max(0.0, std::floor(n / 2.0 - spread)));
+    size_t highRank = std::min(n - 1, static_cast<size_t>(std::ceil(n / 2.0 + spread)));
+    return {samples[n / 2], samples[lowRank], samples[highRank]};
+}
+
+std::vector<double> sampleUntilStable(const RegressionCase& benchCase) {
+    // Untimed runs first so code, data and the branch predictors are warm
+    for (int w = 0; w < kWarmupRuns; w++) {
+        benchCase.prepare();
+        benchCase.run();
+    }
+
+    std::vector<double> samples;
+    double spentMs = 0.0;
+    while (samples.size() < kMaxSamples) {
+        benchCase.prepare();
+        auto startTime = std::chrono::steady_clock::now();
+        benchCase.run();
+        auto endTime = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        samples.push_back(ms);
+        spentMs += ms;
+
+        if (samples.size() < kMinSamples) continue;
+        MedianInterval interval = medianInterval(samples);
+        bool tight = interval.high - interval.low <= 2.0 * kTargetCiHalfWidth * interval.median;
+        if (tight || spentMs > kCaseBudgetMs) break;
+    }
+    return samples;
+}
+
+// One-sided Mann-Whitney U test, normal approximation with tie correction:
+// the p-value for "samples in `slower` tend to be larger than in `faster`"
+double mannWhitneyP(const std::vector<double>& faster, const std::vector<double>& slower) {
+    const double n1 = static_cast<double>(faster.size());
+    const double n2 = static_cast<double>(slower.size());
+    if (n1 == 0 || n2 == 0) return 1.0;
+
+    std::vector<std::pair<double, int>> pooled;
+    for (double v : faster) pooled.push_back({v, 0});
+    for (double v : slower) pooled.push_back({v, 1});
+    std::sort(pooled.begin(), pooled.end());
+
+    double slowerRankSum = 0.0;
+    double tieTerm = 0.0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) j++;
+        double averageRank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++) {
+            if (pooled[k].second == 1) slowerRankSum += averageRank;
+        }
+        double ties = static_cast<double>(j - i);
+        tieTerm += ties * ties * ties - ties;
+        i = j;
+    }
+
+    const double total = n1 + n2;
+    const double u = slowerRankSum - n2 * (n2 + 1) / 2.0;
+    const double mean = n1 * n2 / 2.0;
+    const double variance = n1 * n2 / 12.0 * ((total + 1) - tieTerm / (total * (total - 1)));
+    if (variance <= 0) return 1.0;
+    const double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+std::vector<RegressionCase> regressionCases() {
+    static std::vector<int> work;
+    static std::vector<float> floatWork;
+    static VisualizerState quickState(sortmem::arena());
+    auto noStep = [](const std::vector<int>&, int, int, const std::string&) {};
+    auto noFloatStep = [](const std::vector<float>&, int, int, const std::string&) {};
+
+    std::vector<RegressionCase> cases;
+    const std::pair<const char*, SortChoice> kernels[] = {
+        {"radix", SortChoice::Radix},
+        {"counting", SortChoice::Counting},
+        {"natural-merge", SortChoice::NaturalMerge},
+        {"introsort", SortChoice::Introsort},
+    };
+    for (size_t n : {10000, 1000000}) {
+        for (const char* distribution : {"random", "small-range", "sorted+tail"}) {
+            auto input = std::make_shared<std::vector<int>>(intInput(distribution, n, 31));
+            for (const auto& kernel : kernels) {
+                // Counting sort on full-range keys would only measure the table allocation
+                if (kernel.second == SortChoice::Counting && std::string(distribution) == "random") continue;
+                SortChoice choice = kernel.second;
+                cases.push_back({std::string(kernel.first) + "/" + std::to_string(n) + "/" + distribution, n,
+                                 [input] { work = *input; },
+                                 [choice] { runSortChoice(work, choice); }});
+            }
+        }
+        auto floats = std::make_shared<std::vector<float>>(uniformFloats(n, -1.0f, 1.0f, 37));
+        cases.push_back({"floatRadixSort/" + std::to_string(n) + "/uniform", n,
+                         [floats] { floatWork = *floats; },
+                         [noFloatStep] { floatRadixSort(floatWork, noFloatStep); }});
+    }
+
+    // The visual sorts, step strings and all; small n because every step is recorded
+    auto small = std::make_shared<std::vector<int>>(intInput("small-range", 1000, 41));
+    cases.push_back({"radixSort(visual)/1000/small-range", 1000,
+                     [small] { work = *small; },
+                     [noStep] { radixSort(work, noStep); }});
+    cases.push_back({"quickSort(visual)/1000/small-range", 1000,
+                     [small] {
+                         work = *small;
+                         // Drop the arena-backed step storage before the arena itself
+                         std::pmr::vector<QuickSortStep>(quickState.memory).swap(quickState.quickSortSteps);
+                         sortmem::releaseArena();
+                     },
+                     [] { quickSort(work, quickState, 0, static_cast<int>(work.size()) - 1); }});
+    return cases;
+}
+
+using Baseline = std::map<std::string, std::vector<double>>;
+
+// One case per line: name, a tab, then comma-separated run times in ms
+bool saveBaseline(const std::string& path, const Baseline& baseline) {
+    std::ofstream out(path);
+    out << "# sort benchmark baseline: case<TAB>run times in ms\n";
+    out << std::setprecision(9);
+    for (const auto& entry : baseline) {
+        out << entry.first << "\t";
+        for (size_t i = 0; i < entry.second.size(); i++) out << (i ? "," : "") << entry.second[i];
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool loadBaseline(const std::string& path, Baseline& baseline) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) continue;
+        std::vector<double>& samples = baseline[line.substr(0, tab)];
+        std::istringstream values(line.substr(tab + 1));
+        std::string value;
+        while (std::getline(values, value, ',')) samples.push_back(std::strtod(value.c_str(), nullptr));
+    }
+    return true;
+}
+
+enum class Verdict { Same, Regressed, Faster };
+
+struct Comparison {
+    double baseMs;
+    double nowMs;
+    double ciPercent;
+    double throughputChange;  // baseline time / current time - 1
+    double p;                 // one-sided p-value in the direction of the change
+    Verdict verdict;
+};
+
+Comparison compareSamples(const std::vector<double>& base, const std::vector<double>& now,
+                          double threshold) {
+    MedianInterval baseInterval = medianInterval(base);
+    MedianInterval nowInterval = medianInterval(now);
+    Comparison result{};
+    result.baseMs = baseInterval.median;
+    result.nowMs = nowInterval.median;
+    result.ciPercent = nowInterval.median > 0
+        ? 50.0 * (nowInterval.high - nowInterval.low) / nowInterval.median : 0.0;
+    result.throughputChange = nowInterval.median > 0 ? baseInterval.median / nowInterval.median - 1.0 : 0.0;
+    double slowerP = mannWhitneyP(base, now);
+    double fasterP = mannWhitneyP(now, base);
+    result.p = std::min(slowerP, fasterP);
+    result.verdict = Verdict::Same;
+    if (result.throughputChange < -threshold && slowerP < kSignificance) {
+        result.verdict = Verdict::Regressed;
+    } else if (result.throughputChange > threshold && fasterP < kSignificance) {
+        result.verdict = Verdict::Faster;
+    }
+    return result;
+}
+
+// --record: sample every case and overwrite the baseline file.
+// --compare: sample every case and diff against it. Returns the exit code.
+int runRegressionMode(bool record, const std::string& path, double threshold) {
+    pinToCurrentCore();
+
+    Baseline baseline;
+    if (!record && !loadBaseline(path, baseline)) {
+        std::cerr << "No baseline at " << path << "; run with --record first\n";
+        return 2;
+    }
+
+    std::cout << "\n== " << (record ? "Recording baseline " : "Regression check against ") << path
+              << " (threshold " << threshold * 100.0 << "%, p < "
+              << kSignificance << ") ==\n"
+              << std::left << std::setw(38) << "case"
+              << std::right << std::setw(12) << "base ms"
+              << std::setw(12) << "now ms"
+              << std::setw(10) << "CI +-%"
+              << std::setw(12) << "throughput"
+              << std::setw(10) << "p"
+              << "  status\n";
+
+    Baseline current;
+    int regressions = 0;
+    for (const RegressionCase& benchCase : regressionCases()) {
+        std::vector<double> samples = sampleUntilStable(benchCase);
+        current[benchCase.name] = samples;
+
+        std::cout << std::left << std::setw(38) << benchCase.name << std::right << std::fixed;
+        auto found = baseline.find(benchCase.name);
+        if (record || found == baseline.end()) {
+            MedianInterval now = medianInterval(samples);
+            std::cout << std::setw(12) << "-" << std::setw(12) << std::setprecision(4) << now.median
+                      << std::setw(10) << std::setprecision(1) << 50.0 * (now.high - now.low) / now.median
+                      << std::setw(12) << "-" << std::setw(10) << "-"
+                      << "  " << (record ? "recorded" : "NEW (not in baseline)") << std::endl;
+            continue;
+        }
+
+        Comparison result = compareSamples(found->second, samples, threshold);
+        bool confirmed = false;
+        if (result.verdict == Verdict::Regressed) {
+            samples = sampleUntilStable(benchCase);
+            current[benchCase.name] = samples;
+            result = compareSamples(found->second, samples, threshold);
+            confirmed = true;
+        }
+        const char* status = "ok";
+        if (result.verdict == Verdict::Regressed) {
+            status = "REGRESSED";
+            regressions++;
+        } else if (result.verdict == Verdict::Faster) {
+            status = "faster";
+        } else if (confirmed) {
+            status = "ok (not reproduced)";
+        }
+
+        std::ostringstream change;
+        change << std::showpos << std::fixed << std::setprecision(1) << result.throughputChange * 100.0 << "%";
+        std::cout << std::setw(12) << std::setprecision(4) << result.baseMs
+                  << std::setw(12) << result.nowMs
+                  << std::setw(10) << std::setprecision(1) << result.ciPercent
+                  << std::setw(12) << change.str()
+                  << std::setw(10) << std::setprecision(4) << result.p
+                  << "  " << status << std::endl;
+    }
+
+    if (record) {
+        if (!saveBaseline(path, current)) {
+            std::cerr << "Could not write " << path << "\n";
+            return 2;
+        }
+        std::cout << "Baseline written to " << path << "\n";
+        return 0;
+    }
+    if (regressions > 0) {
+        std::cout << std::defaultfloat << regressions << " case(s) regressed by more than "
+                  << threshold * 100.0 << "% throughput\n";
+        return 1;
+    }
+    std::cout << "No regressions\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && (std::string(argv[1]) == "--record" || std::string(argv[1]) == "--compare")) {
+        double threshold = kDefaultRegressionThreshold;
+        if (argc > 3) {
+            // A typo must not turn into a 0% threshold that flags every case
+            char* end = nullptr;
+            double percent = std::strtod(argv[3], &end);
+            if (end == argv[3] || *end != '\0' || !std::isfinite(percent) || percent < 0.0) {
+                std::cerr << "Invalid threshold '" << argv[3] << "': expected a percentage such as 5\n"
+                          << "Usage: " << argv[0] << " --record|--compare [baseline] [threshold %]\n";
+                return 2;
+            }
+            threshold = percent / 100.0;
+        }
+        return runRegressionMode(std::string(argv[1]) == "--record",
+                                 argc > 2 ? argv[2] : kDefaultBaselinePath, threshold);
+    }
+
+    std::vector<size_t> sizes;
+    std::vector<std::string> datasetPaths;
+    std::vector<adversary::Dataset> datasets;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--plugin" && i + 1 < argc) {
+            std::string error;
+            if (!loadSortPlugin(argv[++i], error)) {
+                std::cerr << "Could not load plug-in: " << error << "\n";
+                return 2;
+            }
+            continue;
+        }
+        if (std::string(argv[i]) == "--dataset" && i + 1 < argc) {
+            adversary::Dataset dataset;
+            std::string error;
+            if (!adversary::loadDataset(argv[++i], dataset, error)) {
+                std::cerr << "Could not load dataset: " << error << "\n";
+                return 2;
+            }
+            datasetPaths.push_back(argv[i]);
+            datasets.push_back(std::move(dataset));
+            continue;
+        }
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) sizes = {1000, 10000, 100000, 1000000};
+
+    benchFloatSorts(sizes);
+    benchSelection(sizes);
+    benchStreaming(sizes);
+    benchSampleSortScaling(sizes);
+    benchHeapSort(sizes);
+    benchScatterTuning(sizes);
+    benchAllocations();
+    benchConvergence();
+    int wrongKernels = benchKernels(sizes, datasets);
+    wrongKernels += benchVisualAliasing();
+    benchDatasets(datasetPaths, datasets);
+    int misses = benchDispatcher(sizes);
+    return misses == 0 && wrongKernels == 0 ? 0 : 1;
+}
@@ -1,327 +1,957 @@
-#include <SFML/Graphics.hpp>
-#include <vector>
-#include <functional>
-#include <thread>
-#include <chrono>
-#include <random>
-#include <sstream>
-#include <iomanip>
-#include "Visualizer.hpp"
-#include "SortAlgorithms.hpp"
-
-std::vector<int> generateRandomIntArray(int size, int min, int max) {
-    std::vector<int> arr(size);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(min, max);
-    for (int& num : arr) {
-        num = dist(gen);
-    }
-    return arr;
-}
-
-std::vector<float> generateRandomFloatArray(int size, float min, float max) {
-    std::vector<float> arr(size);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dist(min, max);
-    for (float& num : arr) {
-        num = dist(gen);
-    }
-    return arr;
-}
-
-int main() {
-    sf::RenderWindow window(sf::VideoMode(1200, 700), "Sorting Visualizer");
-    sf::Font font;
-    if (!font.loadFromFile("Fonts/Roboto-Regular.ttf")) {
-        return -1;
-    }
-
-    VisualizerState state;
-    state.array = generateRandomIntArray(10, 1, 99);
-    state.floatArray = generateRandomFloatArray(10, 0.0f, 1.0f);
-    state.currentStep = "Press S:Bubble | I:Insertion | Q:Quick | 4:Bucket | 5:Radix | 6:Counting";
-    SortStats stats;
-
-    std::function<void()> sortFunction;
-    bool sortRequested = false;
-    bool bucketView = false;
-    bool isQuickSortActive = false;
-    bool isCountingSortActive = false;
-
-    auto intCallback = [&](const std::vector<int>& arr, int i, int j, const std::string& explanation) {
-        state.array = arr;
-        state.highlightedIndex = i;
-        state.secondaryIndex = j;
-        state.currentStep = explanation;
-
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) window.close();
-        }
-
-        window.clear(sf::Color(230, 230, 230));
-        
-        if (isCountingSortActive) {
-            drawCountingSort(window, state.array, state.countArray, 
-                           state.highlightedIndex, font);
-        } else {
-            drawArray(window, state.array, state.highlightedIndex, state.secondaryIndex, font);
-        }
-        
-        drawExplanation(window, state.currentStep, font);
-        window.display();
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / state.speed)));
-    };
-
-    auto bucketCallback = [&](const std::vector<std::vector<float>>& buckets, const std::string& explanation) {
-        state.bucketData = buckets;
-        state.currentStep = explanation;
-
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) window.close();
-        }
-
-        window.clear(sf::Color(230, 230, 230));
-        drawBuckets(window, state.bucketData, state.currentStep, font);
-        window.display();
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / state.speed)));
-    };
-
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) window.close();
-            if (event.type == sf::Event::KeyPressed) {
-                if (event.key.code == sf::Keyboard::R) {
-                    state.array = generateRandomIntArray(10, 1, 99);
-                    state.floatArray = generateRandomFloatArray(10, 0.0f, 1.0f);
-                    state.isSorting = false;
-                    sortRequested = false;
-                    bucketView = false;
-                    isQuickSortActive = false;
-                    isCountingSortActive = false;
-                    state.bucketData.clear();
-                    state.quickSortSteps.clear();
-                    state.currentQuickStep = 0;
-                    state.currentDigit = -1;
-                    state.countArray.clear();
-                    state.currentStep = "Press S:Bubble | I:Insertion | Q:Quick | 4:Bucket | 5:Radix | 6:Counting";
-                }
-                else if (event.key.code == sf::Keyboard::S && !state.isSorting) {
-                    sortFunction = [&]() { bubbleSort(state.array, intCallback); };
-                    state.isSorting = true;
-                    sortRequested = true;
-                    bucketView = false;
-                    isQuickSortActive = false;
-                    isCountingSortActive = false;
-                }
-                else if (event.key.code == sf::Keyboard::I && !state.isSorting) {
-                    sortFunction = [&]() { insertionSort(state.array, intCallback); };
-                    state.isSorting = true;
-                    sortRequested = true;
-                    bucketView = false;
-                    isQuickSortActive = false;
-                    isCountingSortActive = false;
-                }
-                else if (event.key.code == sf::Keyboard::Q && !state.isSorting) {
-                    state.currentStep = "Generating Quick Sort steps...";
-                    state.quickSortSteps.clear();
-                    state.currentQuickStep = 0;
-                    isQuickSortActive = true;
-                    state.isSorting = true;
-                    bucketView = false;
-                    isCountingSortActive = false;
-
-                    std::vector<int> tempArray = state.array;
-                    quickSort(tempArray, state, 0, tempArray.size() - 1);
-                    
-                    if (!state.quickSortSteps.empty()) {
-                        state.array = state.quickSortSteps.back().array;
-                        state.currentQuickStep = 0;
-                        state.currentStep = state.quickSortSteps[0].explanation;
-                    } else {
-                        state.currentStep = "No Quick Sort steps were generated.";
-                    }
-                    state.isSorting = false;
-                }
-                else if (event.key.code == sf::Keyboard::Num4 && !state.isSorting) {
-                    sortFunction = [&]() {
-                        state.bucketData.clear();
-                        state.currentStep = "Starting Bucket Sort...";
-                        state.floatArray = generateRandomFloatArray(10, 0.0f, 1.0f);
-                        window.clear(sf::Color(230, 230, 230));
-                        drawBuckets(window, state.bucketData, state.currentStep, font);
-                        window.display();
-                        std::this_thread::sleep_for(std::chrono::milliseconds(400));
-                        bucketSort(state.floatArray, stats, state, bucketCallback);
-                    };
-                    state.isSorting = true;
-                    sortRequested = true;
-                    bucketView = true;
-                    isQuickSortActive = false;
-                    isCountingSortActive = false;
-                }
-                else if (event.key.code == sf::Keyboard::Num5 && !state.isSorting) {
-                    sortFunction = [&]() { radixSort(state.array, intCallback); };
-                    state.isSorting = true;
-                    sortRequested = true;
-                    bucketView = false;
-                    isQuickSortActive = false;
-                    isCountingSortActive = false;
-                }
-                else if (event.key.code == sf::Keyboard::Num6 && !state.isSorting) {
-                    for (auto& num : state.array) {
-                        num = std::min(num, 30);
-                    }
-                    
-                    sortFunction = [&]() { 
-                        state.countArray.clear();
-                        countingSort(state.array, intCallback, state); 
-                    };
-                    state.isSorting = true;
-                    sortRequested = true;
-                    bucketView = false;
-                    isQuickSortActive = false;
-                    isCountingSortActive = true;
-                }
-                else if (event.key.code == sf::Keyboard::Up) {
-                    state.speed = std::min(state.speed + 0.5f, 5.0f);
-                }
-                else if (event.key.code == sf::Keyboard::Down) {
-                    state.speed = std::max(state.speed - 0.5f, 0.5f);
-                }
-                else if (event.key.code == sf::Keyboard::Right && isQuickSortActive) {
-                    if (state.currentQuickStep < state.quickSortSteps.size() - 1) {
-                        state.currentQuickStep++;
-                    }
-                }
-                else if (event.key.code == sf::Keyboard::Left && isQuickSortActive) {
-                    if (state.currentQuickStep > 0) {
-                        state.currentQuickStep--;
-                    }
-                }
-                else if (event.key.code == sf::Keyboard::Space && isQuickSortActive) {
-                    while (state.currentQuickStep < state.quickSortSteps.size() - 1) {
-                        state.currentQuickStep++;
-
-                        window.clear(sf::Color(230, 230, 230));
-                        drawQuickSortVisualization(window, state.quickSortSteps[state.currentQuickStep], 
-                         state, stats, font);
-
-                        sf::Text instructions;
-                        instructions.setFont(font);
-                        instructions.setString("LEFT/RIGHT: Navigate | SPACE: Auto-play | R: Reset");
-                        instructions.setCharacterSize(20);
-                        instructions.setFillColor(sf::Color::Black);
-                        instructions.setPosition(20, 550);
-                        window.draw(instructions);
-
-                        sf::Text explanation;
-                        explanation.setFont(font);
-                        explanation.setString(state.quickSortSteps[state.currentQuickStep].explanation);
-                        explanation.setCharacterSize(22);
-                        explanation.setFillColor(sf::Color::Black);
-                        explanation.setPosition(20, 580);
-                        window.draw(explanation);
-
-                        sf::Text stepCounter;
-                        stepCounter.setFont(font);
-                        stepCounter.setString("Step " + std::to_string(state.currentQuickStep + 1) +
-                                            " of " + std::to_string(state.quickSortSteps.size()));
-                        stepCounter.setCharacterSize(20);
-                        stepCounter.setFillColor(sf::Color::Black);
-                        stepCounter.setPosition(20, 620);
-                        window.draw(stepCounter);
-
-                        window.display();
-                        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(1000 / state.speed)));
-
-                        sf::Event quickEvent;
-                        while (window.pollEvent(quickEvent)) {
-                            if (quickEvent.type == sf::Event::KeyPressed &&
-                                quickEvent.key.code == sf::Keyboard::Space) {
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        if (sortRequested && sortFunction && !isQuickSortActive) {
-            sortFunction();
-            sortRequested = false;
-            state.isSorting = false;
-        }
-
-        window.clear(sf::Color(230, 230, 230));
-
-        if (isQuickSortActive) {
-            if (!state.quickSortSteps.empty()) {
-                state.currentQuickStep = std::min(state.currentQuickStep, (int)state.quickSortSteps.size() - 1);
-
-                const auto& currentStep = state.quickSortSteps[state.currentQuickStep];
-                drawQuickSortVisualization(window, currentStep, state, stats, font);
-
-                sf::Text instructions;
-                instructions.setFont(font);
-                instructions.setString("LEFT/RIGHT: Navigate | SPACE: Auto-play | R: Reset");
-                instructions.setCharacterSize(20);
-                instructions.setFillColor(sf::Color::Black);
-                instructions.setPosition(20, 550);
-                window.draw(instructions);
-
-                sf::Text explanation;
-                explanation.setFont(font);
-                explanation.setString(currentStep.explanation);
-                explanation.setCharacterSize(22);
-                explanation.setFillColor(sf::Color::Black);
-                explanation.setPosition(20, 580);
-                window.draw(explanation);
-
-                sf::Text stepCounter;
-                stepCounter.setFont(font);
-                stepCounter.setString("Step " + std::to_string(state.currentQuickStep + 1) +
-                                    " of " + std::to_string(state.quickSortSteps.size()));
-                stepCounter.setCharacterSize(20);
-                stepCounter.setFillColor(sf::Color::Black);
-                stepCounter.setPosition(20, 620);
-                window.draw(stepCounter);
-            } else {
-                static sf::Clock loadingClock;
-                if (loadingClock.getElapsedTime().asSeconds() < 2.0f) {
-                    sf::Text loadingText;
-                    loadingText.setFont(font);
-                    loadingText.setString("Generating Quick Sort steps...");
-                    loadingText.setCharacterSize(24);
-                    loadingText.setFillColor(sf::Color::Black);
-                    loadingText.setPosition(20, 580);
-                    window.draw(loadingText);
-                } else {
-                    state.currentStep = "Failed to generate Quick Sort steps";
-                    isQuickSortActive = false;
-                }
-            }
-        }
-        else if (bucketView) {
-            drawBuckets(window, state.bucketData, state.currentStep, font);
-        }
-        else if (isCountingSortActive) {
-            drawCountingSort(window, state.array, state.countArray, 
-                            state.highlightedIndex, font);
-        }
-        else {
-            drawArray(window, state.array, state.highlightedIndex, state.secondaryIndex, font);
-        }
-
-        drawExplanation(window, state.currentStep, font);
-        window.display();
-    }
-
-    return 0;
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include "Visualizer.hpp"
+#include "SortAlgorithms.hpp"
+#include "StreamingContainer.hpp"
+#include "TraceRing.hpp"
+#include "Profiler.hpp"
+#include "SortMemory.hpp"
+#include "SortKernels.hpp"
+#include "AdversarialSearch.hpp"
+#include "Sortedness.hpp"
+
+std::vector<int> generateRandomIntArray(int size, int min, int max) {
+    std::vector<int> arr(size);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dist(min, max);
+    for (int& num : arr) {
+        num = dist(gen);
+    }
+    return arr;
+}
+
+// Inputs for A, each shaped to reach a different analyzer decision. Forty
+// elements is past the size where everything goes to insertion sort, and
+// still few enough for the values to be read.
+const int kAdaptiveDemoSize = 40;
+const int kAdaptiveDemoShapes = 5;
+
+std::vector<int> generateAdaptiveDemoArray(int shape) {
+    std::vector<int> arr;
+    switch (shape % kAdaptiveDemoShapes) {
+        case 0:  // wide random keys: introsort
+            return generateRandomIntArray(kAdaptiveDemoSize, 1, 999);
+        case 1:  // one descending run: natural merge
+            arr = generateRandomIntArray(kAdaptiveDemoSize, 1, 999);
+            std::sort(arr.rbegin(), arr.rend());
+            return arr;
+        case 2:  // one pair out of order: insertion
+            // Distinct steps, so the swapped pair is never equal
+            arr = generateRandomIntArray(kAdaptiveDemoSize, 1, 20);
+            for (int i = 1; i < kAdaptiveDemoSize; i++) arr[i] += arr[i - 1];
+            std::swap(arr[kAdaptiveDemoSize / 2], arr[kAdaptiveDemoSize / 2 + 1]);
+            return arr;
+        case 3:  // keys in [0, n): counting
+            return generateRandomIntArray(kAdaptiveDemoSize, 0, kAdaptiveDemoSize - 1);
+        default: {  // four distinct keys far apart: 3-way partitioning
+            arr = generateRandomIntArray(kAdaptiveDemoSize, 1, 4);
+            for (int& value : arr) value *= 200;
+            return arr;
+        }
+    }
+}
+
+std::vector<float> generateRandomFloatArray(int size, float min, float max) {
+    std::vector<float> arr(size);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<float> dist(min, max);
+    for (float& num : arr) {
+        num = dist(gen);
+    }
+    return arr;
+}
+
+std::vector<std::string> generateRandomStringArray(int size) {
+    // Shared stems so the string sorts have common prefixes to skip
+    static const std::vector<std::string> stems = {"app", "apple", "band", "bandana", "can", "cantor"};
+    std::vector<std::string> arr(size);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> stemDist(0, static_cast<int>(stems.size()) - 1);
+    std::uniform_int_distribution<> lenDist(0, 3);
+    std::uniform_int_distribution<> charDist('a', 'e');
+    for (std::string& str : arr) {
+        str = stems[stemDist(gen)];
+        int extra = lenDist(gen);
+        for (int i = 0; i < extra; ++i) str += static_cast<char>(charDist(gen));
+    }
+    return arr;
+}
+
+// Arguments are sort plug-ins (see SortPlugin.h); G runs their kernels
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string error;
+        if (!loadSortPlugin(argv[i], error)) std::cerr << "Skipping plug-in: " << error << "\n";
+    }
+
+    sf::RenderWindow window(sf::VideoMode(1200, 700 + kMinimapBandHeight), "Sorting Visualizer");
+    window.setFramerateLimit(60);
+    sf::Font font;
+    if (!font.loadFromFile("Fonts/Roboto-Regular.ttf")) {
+        return -1;
+    }
+
+    // The visualizer runs one sort at a time, so its temporaries can all
+    // come from the single sort arena
+    VisualizerState state(sortmem::arena());
+    state.array = generateRandomIntArray(10, 1, 99);
+    state.floatArray = generateRandomFloatArray(10, 0.0f, 1.0f);
+    state.stringArray = generateRandomStringArray(10);
+    state.currentStep = "Press S:Bubble | I:Insertion | Q:Quick | 4:Bucket | 5:Radix | 6:Counting | 7:Multikey | 8:MSD Radix | 9:Float Radix | A:Adaptive | N:Natural Merge | M:Sample | H:Heap | G:Library/plug-in | D:Dataset | K:Select | T:Top-k | P:Partial | L:Stream | X:Attach trace | E:Record trace";
+    SortStats stats;
+
+    std::function<void()> sortFunction;
+    bool sortRequested = false;
+    bool bucketView = false;
+    bool isQuickSortActive = false;
+    bool isCountingSortActive = false;
+    bool isStringSortActive = false;
+    bool isStreamActive = false;
+    size_t kernelIndex = 0;  // next registered kernel G runs
+    int heapSortArity = 8;  // H advances it before the first run, so that starts binary
+    size_t datasetIndex = 0;  // next file in datasets/ D loads
+    int adaptiveShape = 0;  // next generateAdaptiveDemoArray shape A runs on
+    bool keepFloatArray = false;  // a loaded bucketSort dataset replaces 4's random input once
+
+    // Sortedness after every step of the current run, for the minimap; the
+    // previous run's curve stays behind in grey to compare against
+    RunHistory runHistory;
+    std::vector<float> previousRun;
+    auto startRunHistory = [&]() {
+        if (runHistory.steps() > 1) previousRun = runHistory.sortednessCurve(1200);
+        runHistory.clear();
+    };
+
+    // QuickSort steps are pulled from a coroutine only when the viewer
+    // advances; quickSortSteps memoizes the ones already visited.
+    StepGenerator<QuickSortStep> quickSortGenerator;
+    bool quickSortExhausted = false;
+    auto advanceQuickStep = [&]() {
+        if (state.currentQuickStep + 1 < (int)state.quickSortSteps.size()) {
+            state.currentQuickStep++;
+            runHistory.seek(state.currentQuickStep);
+            return true;
+        }
+        if (quickSortExhausted) return false;
+        profiler::ScopedSpan span("quicksort.next");
+        if (const QuickSortStep* step = quickSortGenerator.next()) {
+            state.quickSortSteps.push_back(*step);
+            runHistory.record(step->array.data(), step->array.size());
+            state.currentQuickStep = (int)state.quickSortSteps.size() - 1;
+            return true;
+        }
+        quickSortExhausted = true;
+        if (!state.quickSortSteps.empty()) {
+            const auto& sorted = state.quickSortSteps.back().array;
+            state.array.assign(sorted.begin(), sorted.end());
+        }
+        return false;
+    };
+    auto quickStepCounter = [&]() {
+        return "Step " + std::to_string(state.currentQuickStep + 1) + " of " +
+               std::to_string(state.quickSortSteps.size()) + (quickSortExhausted ? "" : "+");
+    };
+
+    // Sort temporaries, buckets and QuickSort steps live in the sort arena;
+    // dropping the arena-backed containers first lets the whole arena go in
+    // one step
+    sortmem::Counters sortStartCounters = sortmem::counters();
+    sortmem::Counters lastSortAllocs;
+    auto releaseSortMemory = [&]() {
+        quickSortGenerator.reset();
+        std::pmr::vector<QuickSortStep>(state.memory).swap(state.quickSortSteps);
+        BucketList(state.memory).swap(state.bucketData);
+        sortmem::releaseArena();
+    };
+    auto allocationSummary = [&]() {
+        sortmem::Counters now = sortmem::counters();
+        sortmem::Counters current = (state.isSorting || isQuickSortActive) ? sortmem::since(sortStartCounters, now) : lastSortAllocs;
+        std::ostringstream oss;
+        oss << "Sort: " << current.allocations << " allocs, " << current.bytes / 1024 << " KB | "
+            << "Heap: " << now.allocations << " allocs, live " << now.liveBytes / 1024
+            << " KB, peak " << now.peakBytes / 1024 << " KB | "
+            << "Arena: " << sortmem::arenaBytes() / 1024 << " KB";
+        return oss.str();
+    };
+
+    // Streaming mode: a tiny buffer so flushes and compactions are visible
+    SortedChunkStore streamStore(4);
+    StreamSource streamSource;
+    sf::Clock streamClock;
+    long long streamInserts = 0;
+    double streamInsertNs = 0.0;
+    double streamQueryNs = 0.0;
+
+    // External producers (see trace_demo.cpp) stream steps through shared memory
+    trace::TraceConsumer traceConsumer;
+    bool isTraceActive = false;
+    sf::Clock traceClock;
+    const trace::Event* shownTraceEvent = nullptr;
+
+    // CPU cost of the two regimes the loop runs in: waiting for input, and
+    // animating (sort callbacks, streamed inserts, trace events)
+    double idleCpuMs = 0.0;
+    double idleWallMs = 0.0;
+    double animatedCpuMs = 0.0;
+    long long animatedSteps = 0;
+    auto statsSummary = [&]() {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1)
+            << "Idle CPU: " << (idleWallMs > 0 ? idleCpuMs * 60000.0 / idleWallMs : 0.0) << " ms/min | "
+            << "Animated: " << (animatedSteps > 0 ? animatedCpuMs / animatedSteps : 0.0) << " ms/step\n"
+            << allocationSummary();
+        return oss.str();
+    };
+
+    // Every view draws into its own cached layer; a layer is redrawn only
+    // after something it shows has changed
+    const sf::Color background(230, 230, 230);
+    RetainedScene scene;
+    if (!scene.create(window.getSize().x, window.getSize().y, kMinimapBandHeight)) {
+        return -1;
+    }
+    // The minimap follows the views whose steps RunHistory records
+    auto showsMinimap = [&]() {
+        if (isTraceActive || isStreamActive) return false;
+        if (isQuickSortActive) return !state.quickSortSteps.empty();
+        return !bucketView && !isCountingSortActive && !isStringSortActive;
+    };
+    // drawArray with none of the extras some sorts lay over it, so a step
+    // only changes the boxes whose value or highlight changed
+    auto showsPlainArray = [&]() {
+        return !isTraceActive && !isStreamActive && !isQuickSortActive && !bucketView &&
+               !isCountingSortActive && !isStringSortActive && state.runBoundaries.empty() &&
+               !state.galloping && state.discarded.empty() && state.threadOf.empty() &&
+               state.heapArity == 0;
+    };
+    bool viewShowedPlainArray = false;
+    auto drawLayer = [&](SceneLayer layer, sf::RenderTarget& target) {
+        if (layer == SceneLayer::Minimap) {
+            if (showsMinimap()) drawProgressMinimap(target, runHistory, font, previousRun);
+            return;
+        }
+        if (layer == SceneLayer::Text) {
+            drawExplanation(target, state.currentStep, font);
+            return;
+        }
+        if (layer == SceneLayer::Stats) {
+            drawStatsOverlay(target, statsSummary(), font);
+            return;
+        }
+
+        viewShowedPlainArray = showsPlainArray();
+        if (isTraceActive) {
+            // Drawn straight out of the shared ring slot
+            if (shownTraceEvent) {
+                if (shownTraceEvent->kind == trace::EventKind::Counting) {
+                    drawCountingSort(target, shownTraceEvent->array(), shownTraceEvent->arrayLength,
+                                     shownTraceEvent->counts(), shownTraceEvent->countLength,
+                                     shownTraceEvent->highlighted, font);
+                } else {
+                    drawArray(target, shownTraceEvent->array(), shownTraceEvent->arrayLength,
+                              shownTraceEvent->highlighted, shownTraceEvent->secondary, font);
+                }
+            }
+        }
+        else if (isStreamActive) {
+            drawSortedRuns(target, streamStore.buffer(), streamStore.runs(),
+                           streamStore.compactedOnLastInsert(), font);
+        }
+        else if (isQuickSortActive) {
+            if (!state.quickSortSteps.empty()) {
+                state.currentQuickStep = std::min(state.currentQuickStep, (int)state.quickSortSteps.size() - 1);
+
+                const auto& currentStep = state.quickSortSteps[state.currentQuickStep];
+                drawQuickSortVisualization(target, currentStep, state, stats, font);
+
+                sf::Text instructions;
+                instructions.setFont(font);
+                instructions.setString("LEFT/RIGHT: Navigate | SPACE: Auto-play | R: Reset");
+                instructions.setCharacterSize(20);
+                instructions.setFillColor(sf::Color::Black);
+                instructions.setPosition(20, 550);
+                target.draw(instructions);
+
+                sf::Text explanation;
+                explanation.setFont(font);
+                explanation.setString(currentStep.explanation.c_str());
+                explanation.setCharacterSize(22);
+                explanation.setFillColor(sf::Color::Black);
+                explanation.setPosition(20, 580);
+                target.draw(explanation);
+
+                sf::Text stepCounter;
+                stepCounter.setFont(font);
+                stepCounter.setString(quickStepCounter());
+                stepCounter.setCharacterSize(20);
+                stepCounter.setFillColor(sf::Color::Black);
+                stepCounter.setPosition(20, 620);
+                target.draw(stepCounter);
+            }
+        }
+        else if (bucketView) {
+            drawBuckets(target, state.bucketData, font, &state.bucketFill);
+        }
+        else if (isCountingSortActive) {
+            drawCountingSort(target, state.array, state.countArray, 
+                            state.highlightedIndex, font, &state.countBins);
+        }
+        else if (isStringSortActive) {
+            drawStringArray(target, state.stringArray, state.highlightedIndex, state.secondaryIndex,
+                            state.currentDigit, font);
+        }
+        else {
+            drawArray(target, state.array, state.highlightedIndex, state.secondaryIndex, font,
+                      state.runBoundaries, state.galloping, state.discarded, state.threadOf);
+            if (state.heapArity > 0) {
+                drawHeapTree(target, state.array, state.heapSize, state.heapArity,
+                             state.highlightedIndex, state.secondaryIndex, font);
+            }
+        }
+    };
+    auto presentFrame = [&]() {
+        profiler::ScopedSpan renderSpan("render", "render");
+        scene.present(window, background, drawLayer);
+    };
+    // One animation step changes the view and the step text; the stats
+    // overlay is only worth re-rasterising a few times a second. viewArea,
+    // when given, is the only part of the view that changed.
+    sf::Clock statsClock;
+    auto presentStep = [&](std::optional<sf::FloatRect> viewArea = std::nullopt) {
+        scene.invalidate(SceneLayer::Minimap);
+        if (viewArea) scene.invalidate(SceneLayer::View, *viewArea);
+        else scene.invalidate(SceneLayer::View);
+        scene.invalidate(SceneLayer::Text);
+        if (statsClock.getElapsedTime().asMilliseconds() >= 250) {
+            scene.invalidate(SceneLayer::Stats);
+            statsClock.restart();
+        }
+        presentFrame();
+        animatedSteps++;
+    };
+
+    // Boxes an array step changes: old and new highlights and every changed
+    // value. nullopt (redraw the whole view) unless the plain array view is
+    // on screen and stays so at the same size.
+    auto changedBoxes = [&](const std::vector<int>& next, int i, int j) -> std::optional<sf::FloatRect> {
+        if (!viewShowedPlainArray || !showsPlainArray() || next.size() != state.array.size()) {
+            return std::nullopt;
+        }
+        const int size = static_cast<int>(next.size());
+        int first = size, last = -1;
+        auto mark = [&](int k) {
+            if (k < 0 || k >= size) return;
+            first = std::min(first, k);
+            last = std::max(last, k);
+        };
+        mark(state.highlightedIndex);
+        mark(state.secondaryIndex);
+        mark(i);
+        mark(j);
+        for (int k = 0; k < size; ++k) {
+            if (next[k] != state.array[k]) mark(k);
+        }
+        return arrayBoxesArea(scene.size(SceneLayer::View), next.size(), first, last);
+    };
+
+    auto intCallback = [&](const std::vector<int>& arr, int i, int j, const std::string& explanation) {
+        profiler::ScopedSpan callbackSpan("intCallback", "callback");
+        std::optional<sf::FloatRect> changed = changedBoxes(arr, i, j);
+        state.array = arr;
+        runHistory.record(arr);
+        state.highlightedIndex = i;
+        state.secondaryIndex = j;
+        state.currentStep = explanation;
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) window.close();
+        }
+
+        presentStep(changed);
+
+        profiler::ScopedSpan sleepSpan("sleep_for", "callback");
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / state.speed)));
+    };
+
+    auto bucketCallback = [&](const BucketList& buckets, const std::string& explanation) {
+        profiler::ScopedSpan callbackSpan("bucketCallback", "callback");
+        if (&buckets != &state.bucketData) state.bucketData = buckets;
+        state.currentStep = explanation;
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) window.close();
+        }
+
+        presentStep();
+
+        profiler::ScopedSpan sleepSpan("sleep_for", "callback");
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / state.speed)));
+    };
+
+    auto floatCallback = [&](const std::vector<float>& arr, int i, int j, const std::string& explanation) {
+        profiler::ScopedSpan callbackSpan("floatCallback", "callback");
+        state.floatArray = arr;
+        std::vector<int> scaled;
+        scaled.reserve(arr.size());
+        for (float val : arr) {
+            scaled.push_back(static_cast<int>(val * 100));
+        }
+        std::optional<sf::FloatRect> changed = changedBoxes(scaled, i, j);
+        state.array = std::move(scaled);
+        runHistory.record(state.array);
+        state.highlightedIndex = i;
+        state.secondaryIndex = j;
+        state.currentStep = explanation + "\n[" + formatFloatArray(arr) + "]";
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) window.close();
+        }
+
+        presentStep(changed);
+
+        profiler::ScopedSpan sleepSpan("sleep_for", "callback");
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / state.speed)));
+    };
+
+    auto stringCallback = [&](const std::vector<std::string>& arr, int i, int j, const std::string& explanation) {
+        profiler::ScopedSpan callbackSpan("stringCallback", "callback");
+        state.stringArray = arr;
+        state.highlightedIndex = i;
+        state.secondaryIndex = j;
+        state.currentStep = explanation;
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) window.close();
+        }
+
+        presentStep();
+
+        profiler::ScopedSpan sleepSpan("sleep_for", "callback");
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(500 / state.speed)));
+    };
+
+    while (window.isOpen()) {
+        // Nothing to animate and nothing stale on screen: sleep in the OS
+        // until the next event instead of spinning on pollEvent
+        bool idle = !sortRequested && !isStreamActive && !isTraceActive && !scene.isDirty();
+        double iterationCpuStart = profiler::processCpuMs();
+        auto iterationWallStart = std::chrono::steady_clock::now();
+        long long stepsAtStart = animatedSteps;
+
+        sf::Event event;
+        for (bool haveEvent = idle ? window.waitEvent(event) : window.pollEvent(event); haveEvent;
+             haveEvent = window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) window.close();
+            if (event.type == sf::Event::KeyPressed || event.type == sf::Event::Resized ||
+                event.type == sf::Event::GainedFocus || event.type == sf::Event::MouseButtonPressed) {
+                scene.invalidateAll();
+            }
+            if (event.type == sf::Event::Resized) {
+                // Keep one unit per pixel and give the layers the new size,
+                // otherwise the old textures are stretched over the window
+                window.setView(sf::View(sf::FloatRect(0.f, 0.f, static_cast<float>(event.size.width),
+                                                      static_cast<float>(event.size.height))));
+                if (!scene.create(event.size.width, event.size.height, kMinimapBandHeight)) window.close();
+            }
+            if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left &&
+                !state.isSorting) {
+                // Window coordinates, then the minimap layer's own, which is
+                // what the strip was laid out in
+                sf::Vector2f point = window.mapPixelToCoords({event.mouseButton.x, event.mouseButton.y});
+                sf::Vector2f origin = scene.origin(SceneLayer::Minimap);
+                point = sf::Vector2f(point.x - origin.x, point.y - origin.y);
+                int step = showsMinimap() ? minimapStepAt(scene.size(SceneLayer::Minimap), runHistory, point) : -1;
+                if (step >= 0 && isQuickSortActive) {
+                    state.currentQuickStep = std::min(step, (int)state.quickSortSteps.size() - 1);
+                } else if (step >= 0 && !bucketView && !isCountingSortActive && !isStringSortActive &&
+                           !isStreamActive && !isTraceActive) {
+                    // Runs, thread colours and the heap tree describe the
+                    // step the sort stopped at, not the one sought to
+                    state.array = runHistory.seek(step);
+                    state.highlightedIndex = -1;
+                    state.secondaryIndex = -1;
+                    state.runBoundaries.clear();
+                    state.discarded.clear();
+                    state.threadOf.clear();
+                    state.heapArity = 0;
+                    const SortednessMetrics& shown = runHistory.metrics();
+                    state.currentStep = "Step " + std::to_string(step + 1) + " of " +
+                                        std::to_string(runHistory.steps()) + ": " +
+                                        std::to_string(shown.inversions) + " inversions, longest run " +
+                                        std::to_string(shown.longestRun) + ", " + std::to_string(shown.inPlace) +
+                                        " of " + std::to_string(shown.n) + " in place";
+                }
+            }
+            if (event.type == sf::Event::KeyPressed) {
+                if (event.key.code == sf::Keyboard::R) {
+                    state.array = generateRandomIntArray(10, 1, 99);
+                    state.floatArray = generateRandomFloatArray(10, 0.0f, 1.0f);
+                    state.stringArray = generateRandomStringArray(10);
+                    state.isSorting = false;
+                    sortRequested = false;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                    state.bucketData.clear();
+                    releaseSortMemory();
+                    lastSortAllocs = sortmem::Counters();
+                    state.currentQuickStep = 0;
+                    state.currentDigit = -1;
+                    state.countArray.clear();
+                    state.runBoundaries.clear();
+                    state.galloping = false;
+                    state.discarded.clear();
+                    state.threadOf.clear();
+                    state.heapArity = 0;
+                    keepFloatArray = false;
+                    runHistory.clear();
+                    previousRun.clear();
+                    isStreamActive = false;
+                    streamStore.clear();
+                    isTraceActive = false;
+                    traceConsumer.detach();
+                    state.currentStep = "Press S:Bubble | I:Insertion | Q:Quick | 4:Bucket | 5:Radix | 6:Counting | 7:Multikey | 8:MSD Radix | 9:Float Radix | A:Adaptive | N:Natural Merge | M:Sample | H:Heap | G:Library/plug-in | D:Dataset | K:Select | T:Top-k | P:Partial | L:Stream | X:Attach trace | E:Record trace";
+                }
+                else if (event.key.code == sf::Keyboard::S && !state.isSorting) {
+                    sortFunction = [&]() { bubbleSort(state.array, intCallback); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::I && !state.isSorting) {
+                    sortFunction = [&]() { insertionSort(state.array, intCallback); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::Q && !state.isSorting) {
+                    isStreamActive = false;
+                    isTraceActive = false;
+                    releaseSortMemory();
+                    state.currentQuickStep = -1;
+                    isQuickSortActive = true;
+                    bucketView = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+
+                    sortStartCounters = sortmem::counters();
+                    startRunHistory();
+                    quickSortGenerator = quickSortStepGenerator(state.array, 0, (int)state.array.size() - 1, state.memory);
+                    quickSortExhausted = false;
+                    if (advanceQuickStep()) {
+                        state.currentStep = state.quickSortSteps[0].explanation;
+                    } else {
+                        state.currentQuickStep = 0;
+                        isQuickSortActive = false;
+                        state.currentStep = "No Quick Sort steps were generated.";
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Num4 && !state.isSorting) {
+                    sortFunction = [&]() {
+                        state.bucketData.clear();
+                        state.currentStep = "Starting Bucket Sort...";
+                        if (!keepFloatArray) state.floatArray = generateRandomFloatArray(10, 0.0f, 1.0f);
+                        keepFloatArray = false;
+                        presentStep();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+                        bucketSort(state.floatArray, stats, state, bucketCallback);
+                    };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = true;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::Num5 && !state.isSorting) {
+                    sortFunction = [&]() { radixSort(state.array, intCallback, state.memory); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::Num6 && !state.isSorting) {
+                    for (auto& num : state.array) {
+                        num = std::min(num, 30);
+                    }
+                    
+                    sortFunction = [&]() { 
+                        state.countArray.clear();
+                        countingSort(state.array, intCallback, state); 
+                    };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = true;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::Num7 && !state.isSorting) {
+                    sortFunction = [&]() { multikeyQuickSort(state.stringArray, stringCallback, state); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = true;
+                }
+                else if (event.key.code == sf::Keyboard::Num8 && !state.isSorting) {
+                    sortFunction = [&]() { msdRadixSort(state.stringArray, stringCallback, state); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = true;
+                }
+                else if (event.key.code == sf::Keyboard::Num9 && !state.isSorting) {
+                    sortFunction = [&]() {
+                        // Signed input so the sign-flip transform has something to do
+                        state.floatArray = generateRandomFloatArray(10, -1.0f, 1.0f);
+                        floatRadixSort(state.floatArray, floatCallback);
+                    };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::A && !state.isSorting) {
+                    sortFunction = [&]() {
+                        state.array = generateAdaptiveDemoArray(adaptiveShape++);
+                        InputProfile profile = analyzeInput(state.array);
+                        SortChoice choice = chooseAlgorithm(profile);
+                        isCountingSortActive = choice == SortChoice::Counting;
+                        state.countArray.clear();
+                        adaptiveSort(state.array, profile, choice, intCallback, state);
+                    };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::N && !state.isSorting) {
+                    sortFunction = [&]() {
+                        // Short minimum runs and an eager gallop threshold so a
+                        // 10-element array still shows merging and galloping
+                        TimSortParams params;
+                        params.minRun = 3;
+                        params.minGallop = 2;
+                        naturalMergeSort(state.array, intCallback, state, params);
+                    };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::M && !state.isSorting) {
+                    sortFunction = [&]() { sampleSort(state.array, intCallback, state, 4); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::H && !state.isSorting) {
+                    // Each press uses the next arity: 2, 4, 8, 2, ...
+                    heapSortArity = heapSortArity >= 8 ? 2 : heapSortArity * 2;
+                    sortFunction = [&]() { heapSort(state.array, intCallback, state, heapSortArity); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::G && !state.isSorting) {
+                    // Registered kernels have no steps: show the result, time and allocations
+                    const SortKernel& kernel = sortKernels()[kernelIndex++ % sortKernels().size()];
+                    sortFunction = [&]() {
+                        sortmem::Counters before = sortmem::counters();
+                        auto startTime = std::chrono::high_resolution_clock::now();
+                        kernel.run(state.array);
+                        auto endTime = std::chrono::high_resolution_clock::now();
+                        sortmem::Counters used = sortmem::since(before, sortmem::counters());
+                        std::ostringstream oss;
+                        oss << kernel.name << " (" << kernel.origin << (kernel.stable ? ", stable" : "")
+                            << ") Complete!\nTime: "
+                            << std::chrono::duration<double, std::milli>(endTime - startTime).count() << "ms\n"
+                            << "Heap allocations: " << used.allocations << " (" << used.bytes << " bytes)\n"
+                            << "Press G for the next of " << sortKernels().size() << " registered kernels";
+                        intCallback(state.array, -1, -1, oss.str());
+                    };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::D && !state.isSorting) {
+                    // Load the next worst-case input saved by the adversary
+                    // tool; Q, 4 or any other sort then runs on it
+                    std::vector<std::string> datasets = adversary::listDatasets("datasets");
+                    adversary::Dataset dataset;
+                    std::string error;
+                    if (datasets.empty()) {
+                        state.currentStep = "No datasets in datasets/ (build and run ./adversary first)";
+                    } else if (!adversary::loadDataset(datasets[datasetIndex++ % datasets.size()], dataset, error)) {
+                        state.currentStep = "Could not load dataset: " + error;
+                    } else {
+                        std::ostringstream oss;
+                        oss << "Loaded " << datasets[(datasetIndex - 1) % datasets.size()] << " (n = "
+                            << dataset.values.size() << ")\nWorst case for " << dataset.target << ": "
+                            << std::fixed << std::setprecision(0) << dataset.score << " " << dataset.objective
+                            << " vs " << dataset.randomScore << " on random input (" << dataset.method << ")\n";
+                        if (dataset.scale > 1) {
+                            state.floatArray.clear();
+                            for (int value : dataset.values) {
+                                state.floatArray.push_back(static_cast<float>(value) / dataset.scale);
+                            }
+                            keepFloatArray = true;
+                            oss << "Press 4 to bucket sort it";
+                        } else {
+                            // Clicking the old run's minimap would seek over the loaded input
+                            startRunHistory();
+                            state.array = dataset.values;
+                            oss << "Press Q to quick sort it, or any other sort key";
+                        }
+                        state.currentStep = oss.str();
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::K && !state.isSorting) {
+                    sortFunction = [&]() {
+                        quickSelect(state.array, static_cast<int>(state.array.size()) / 2, intCallback, state);
+                    };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::T && !state.isSorting) {
+                    sortFunction = [&]() { topK(state.array, 3, intCallback, state); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::P && !state.isSorting) {
+                    sortFunction = [&]() { partialSort(state.array, 3, intCallback, state); };
+                    state.isSorting = true;
+                    sortRequested = true;
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::L && !state.isSorting) {
+                    isStreamActive = !isStreamActive;
+                    if (isStreamActive) {
+                        streamStore.clear();
+                        streamInserts = 0;
+                        streamInsertNs = 0.0;
+                        streamQueryNs = 0.0;
+                        // Tail Data/stream.txt when present, otherwise generate values
+                        bool tailing = streamSource.openFile("Data/stream.txt");
+                        state.currentStep = tailing ? "Streaming from Data/stream.txt (L to stop)"
+                                                    : "Streaming random values (L to stop)";
+                        streamClock.restart();
+                    }
+                    bucketView = false;
+                    isQuickSortActive = false;
+                    isCountingSortActive = false;
+                    isStringSortActive = false;
+                }
+                else if (event.key.code == sf::Keyboard::X && !state.isSorting) {
+                    if (isTraceActive) {
+                        traceConsumer.detach();
+                        isTraceActive = false;
+                        state.currentStep = "Detached from trace ring";
+                    } else if (traceConsumer.attach(trace::kDefaultRingName)) {
+                        isTraceActive = true;
+                        isStreamActive = false;
+                        bucketView = false;
+                        isQuickSortActive = false;
+                        isCountingSortActive = false;
+                        isStringSortActive = false;
+                        shownTraceEvent = nullptr;
+                        traceClock.restart();
+                    } else {
+                        state.currentStep = std::string("No trace ring at ") + trace::kDefaultRingName +
+                                            " (start trace_demo first; needs POSIX shared memory)";
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::E) {
+                    if (!profiler::isEnabled()) {
+                        profiler::reset();
+                        profiler::setEnabled(true);
+                        state.currentStep = "Recording trace spans... press E again to export";
+                    } else {
+                        profiler::setEnabled(false);
+                        bool written = profiler::writeChromeTrace("sort_trace.json");
+                        state.currentStep = written
+                            ? "Wrote " + std::to_string(profiler::spanCount()) + " spans to sort_trace.json (" +
+                              std::to_string(profiler::droppedCount()) + " dropped); open it in Perfetto"
+                            : std::string("Could not write sort_trace.json");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Up) {
+                    state.speed = std::min(state.speed + 0.5f, 5.0f);
+                }
+                else if (event.key.code == sf::Keyboard::Down) {
+                    state.speed = std::max(state.speed - 0.5f, 0.5f);
+                }
+                else if (event.key.code == sf::Keyboard::Right && isQuickSortActive) {
+                    advanceQuickStep();
+                }
+                else if (event.key.code == sf::Keyboard::Left && isQuickSortActive) {
+                    if (state.currentQuickStep > 0) {
+                        state.currentQuickStep--;
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Space && isQuickSortActive) {
+                    while (advanceQuickStep()) {
+                        presentStep();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(1000 / state.speed)));
+
+                        sf::Event quickEvent;
+                        while (window.pollEvent(quickEvent)) {
+                            if (quickEvent.type == sf::Event::KeyPressed &&
+                                quickEvent.key.code == sf::Keyboard::Space) {
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // LEFT/RIGHT, auto-play and clicks all move currentQuickStep; the
+        // minimap follows it here, one undo or replay per step moved
+        if (isQuickSortActive && state.currentQuickStep >= 0 &&
+            runHistory.position() != static_cast<size_t>(state.currentQuickStep)) {
+            runHistory.seek(state.currentQuickStep);
+        }
+
+        if (sortRequested && sortFunction && !isQuickSortActive) {
+            state.discarded.clear();
+            state.runBoundaries.clear();
+            state.threadOf.clear();
+            state.heapArity = 0;
+            isStreamActive = false;
+            isTraceActive = false;
+            releaseSortMemory();
+            sortStartCounters = sortmem::counters();
+            startRunHistory();
+            sortFunction();
+            lastSortAllocs = sortmem::since(sortStartCounters, sortmem::counters());
+            sortRequested = false;
+            state.isSorting = false;
+            scene.invalidateAll();
+        }
+
+        if (isStreamActive &&
+            streamClock.getElapsedTime().asMilliseconds() >= static_cast<int>(500 / state.speed)) {
+            streamClock.restart();
+            int value;
+            if (streamSource.next(value)) {
+                // Start over before the runs stop fitting on screen
+                if (streamStore.size() >= 64) streamStore.clear();
+
+                auto insertStart = std::chrono::high_resolution_clock::now();
+                streamStore.insert(value);
+                auto queryStart = std::chrono::high_resolution_clock::now();
+                size_t rank = streamStore.countLess(value);
+                auto queryEnd = std::chrono::high_resolution_clock::now();
+
+                streamInserts++;
+                streamInsertNs += std::chrono::duration<double, std::nano>(queryStart - insertStart).count();
+                streamQueryNs += std::chrono::duration<double, std::nano>(queryEnd - queryStart).count();
+
+                std::ostringstream oss;
+                oss << "Inserted " << value << " (rank " << rank << " of " << streamStore.size() << ")\n";
+                if (streamStore.compactedOnLastInsert()) oss << streamStore.lastAction() << "\n";
+                oss << std::fixed << std::setprecision(0)
+                    << "Inserts/sec: " << (streamInsertNs > 0 ? streamInserts * 1e9 / streamInsertNs : 0.0)
+                    << std::setprecision(2)
+                    << " | Avg rank query: " << streamQueryNs / streamInserts / 1000.0 << " us"
+                    << " | Flushes: " << streamStore.flushes() << " | Merges: " << streamStore.merges();
+                if (streamSource.skippedTokens() > 0) oss << " | Skipped: " << streamSource.skippedTokens();
+                state.currentStep = oss.str();
+                presentStep();
+            }
+        }
+
+        if (isTraceActive) {
+            // The slot is only handed back to the producer once its event
+            // has been on screen long enough
+            const trace::Event* traceEvent = traceConsumer.peek();
+            std::string status = traceEvent ? std::string(traceEvent->text)
+                               : traceConsumer.producerAlive() ? "Waiting for trace events..."
+                                                               : "Trace producer finished (X to detach)";
+            if (traceEvent != shownTraceEvent || status != state.currentStep) {
+                shownTraceEvent = traceEvent;
+                state.currentStep = status;
+                presentStep();
+            } else if (traceEvent &&
+                       traceClock.getElapsedTime().asMilliseconds() >= static_cast<int>(500 / state.speed)) {
+                traceConsumer.release();
+                shownTraceEvent = nullptr;
+                traceClock.restart();
+            }
+        }
+
+        if (scene.isDirty()) {
+            profiler::ScopedSpan frameSpan("frame", "render");
+            presentFrame();
+        } else if (isStreamActive || isTraceActive) {
+            // Waiting for the next insert or trace event; nothing to redraw
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        double iterationCpuMs = profiler::processCpuMs() - iterationCpuStart;
+        if (animatedSteps != stepsAtStart) {
+            animatedCpuMs += iterationCpuMs;
+        } else if (idle) {
+            idleCpuMs += iterationCpuMs;
+            idleWallMs += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - iterationWallStart).count();
+        }
+    }
+
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+/* Example sort plug-in in plain C, built against SortPlugin.h only:
+ *   cc -O2 -shared -fPIC sort_plugin_demo.c -o sort_plugin_demo.so
+ *   ./benchmark --plugin ./sort_plugin_demo.so
+ *   ./sort_visualizer ./sort_plugin_demo.so      (then press G) */
+
+#include <stdlib.h>
+#include <string.h>
+#include "SortPlugin.h"
+
+/* Shell sort with Ciura's gap sequence, extended by x2.25 */
+static void shellSort(int32_t* data, size_t n) {
+    static const size_t ciura[] = {1, 4, 10, 23, 57, 132, 301, 701, 1750};
+    size_t gaps[64];
+    size_t count = 0;
+    for (; count < sizeof(ciura) / sizeof(ciura[0]) && ciura[count] < n; count++) gaps[count] = ciura[count];
+    while (count > 0 && count < 64 && gaps[count - 1] * 9 / 4 < n) {
+        gaps[count] = gaps[count - 1] * 9 / 4;
+        count++;
+    }
+
+    while (count-- > 0) {
+        size_t gap = gaps[count];
+        for (size_t i = gap; i < n; i++) {
+            int32_t value = data[i];
+            size_t j = i;
+            while (j >= gap && data[j - gap] > value) {
+                data[j] = data[j - gap];
+                j -= gap;
+            }
+            data[j] = value;
+        }
+    }
+}
+
+/* Two-pass LSD radix sort on 16-bit digits (sign bit flipped) */
+static void radix16Sort(int32_t* data, size_t n) {
+    int32_t* buffer = (int32_t*)malloc(n * sizeof(int32_t));
+    size_t* count = (size_t*)malloc(65536 * sizeof(size_t));
+    if (!buffer || !count) {
+        free(buffer);
+        free(count);
+        shellSort(data, n);
+        return;
+    }
+
+    int32_t* from = data;
+    int32_t* to = buffer;
+    for (int shift = 0; shift < 32; shift += 16) {
+        memset(count, 0, 65536 * sizeof(size_t));
+        for (size_t i = 0; i < n; i++) count[(((uint32_t)from[i] ^ 0x80000000u) >> shift) & 0xFFFF]++;
+        size_t offset = 0;
+        for (size_t d = 0; d < 65536; d++) {
+            size_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) to[count[(((uint32_t)from[i] ^ 0x80000000u) >> shift) & 0xFFFF]++] = from[i];
+        int32_t* swap = from;
+        from = to;
+        to = swap;
+    }
+
+    free(buffer);
+    free(count);
+}
+
+static const SortPluginKernel kernels[] = {
+    {"demo-shellsort", 0, shellSort},
+    {"demo-radix16", 1, radix16Sort},
+};
+
+static const SortPluginInfo info = {SORT_PLUGIN_ABI_VERSION, 2, kernels};
+
+SORT_PLUGIN_EXPORT const SortPluginInfo* sort_plugin_info(void) {
+    return &info;
+}
@@ -0,0 +1,88 @@
+#include <vector>
+#include <string>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include "TraceRing.hpp"
+
+// Stand-alone producer for the shared-memory trace ring. It runs its own
+// sort kernels without linking any visualizer code; start it, then press X
+// in the visualizer to attach:
+//   g++ -O2 -std=c++17 trace_demo.cpp -o trace_demo   (add -lrt on older glibc)
+//   ./trace_demo [ring-name]
+
+namespace {
+
+void tracedInsertionSort(std::vector<int>& arr, trace::TraceProducer& producer) {
+    for (size_t i = 1; i < arr.size(); ++i) {
+        int key = arr[i];
+        int j = static_cast<int>(i) - 1;
+        producer.publish(arr.data(), arr.size(), static_cast<int>(i), j, "Picked element " + std::to_string(key));
+        while (j >= 0 && arr[j] > key) {
+            arr[j + 1] = arr[j];
+            producer.publish(arr.data(), arr.size(), j, j + 1, "Shifting " + std::to_string(arr[j]) + " right");
+            j--;
+        }
+        arr[j + 1] = key;
+        producer.publish(arr.data(), arr.size(), j + 1, static_cast<int>(i),
+                         "Inserted " + std::to_string(key) + " at position " + std::to_string(j + 1));
+    }
+    producer.publish(arr.data(), arr.size(), -1, -1, "External insertion sort complete");
+}
+
+void tracedCountingSort(std::vector<int>& arr, trace::TraceProducer& producer) {
+    if (arr.empty()) return;
+    int max = *std::max_element(arr.begin(), arr.end());
+    std::vector<int> count(max + 1, 0);
+    std::vector<int> output(arr.size());
+
+    for (size_t i = 0; i < arr.size(); i++) {
+        count[arr[i]]++;
+        producer.publishCounting(arr.data(), arr.size(), count.data(), count.size(), static_cast<int>(i),
+                                 "Counting occurrence of " + std::to_string(arr[i]));
+    }
+    for (size_t i = 1; i < count.size(); i++) count[i] += count[i - 1];
+    producer.publishCounting(arr.data(), arr.size(), count.data(), count.size(), -1, "Cumulative counts");
+
+    for (int i = static_cast<int>(arr.size()) - 1; i >= 0; i--) {
+        output[--count[arr[i]]] = arr[i];
+        producer.publishCounting(arr.data(), arr.size(), count.data(), count.size(), i,
+                                 "Placing " + std::to_string(arr[i]) + " in output array");
+    }
+    arr = output;
+    producer.publishCounting(arr.data(), arr.size(), count.data(), count.size(), -1,
+                             "External counting sort complete");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string name = argc > 1 ? argv[1] : trace::kDefaultRingName;
+
+    trace::TraceProducer producer;
+    if (!producer.create(name)) {
+        std::cerr << "Could not create shared-memory ring " << name << "\n";
+        return 1;
+    }
+
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dist(1, 30);
+    std::vector<int> arr(10);
+    for (int& num : arr) num = dist(gen);
+
+    std::vector<int> second = arr;
+    tracedInsertionSort(arr, producer);
+    tracedCountingSort(second, producer);
+    producer.finish("Trace demo finished");
+    std::cout << "Published all events to " << name << "\n";
+
+    // The segment outlives this process until it is unlinked. Give the
+    // visualizer time to attach (X) and read the rest, then remove it.
+    std::cout << "Waiting up to 60 s for the visualizer to read them...\n";
+    bool read = producer.waitUntilRead(std::chrono::seconds(60));
+    producer.close();
+    trace::TraceProducer::unlink(name);
+    std::cout << (read ? "Trace read; " : "Timed out; ") << "removed " << name << "\n";
+    return 0;
+}